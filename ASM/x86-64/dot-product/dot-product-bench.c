@@ -0,0 +1,200 @@
+// Every kernel of dot-product.s against a plain C loop: a check of all lengths up to 300 at four alignments,
+// which goes through every tail, then the throughput on 4096 elements, which stay in L1, on 4M elements, which
+// stream from memory, and the mean time of a call on 1 to 15 elements, which is nothing but tail.
+//
+//   gcc -O2 dot-product-bench.c dot-product.s -o dot-product-bench && ./dot-product-bench
+//
+// The per-ISA kernels are hidden, not static, so they link into this executable; the ones the CPU lacks are
+// skipped. The C loops get whatever the compiler makes of them for the default -march.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "dot-product.h"
+
+float dot_product_sse2(size_t N, const float *A, const float *B);
+float dot_product_fma(size_t N, const float *A, const float *B);
+float dot_product_avx512(size_t N, const float *A, const float *B);
+double dot_product_f64_sse2(size_t N, const double *A, const double *B);
+double dot_product_f64_fma(size_t N, const double *A, const double *B);
+double dot_product_f64_avx512(size_t N, const double *A, const double *B);
+int32_t dot_product_i16_sse2(size_t N, const int16_t *A, const int16_t *B);
+int32_t dot_product_i16_avx2(size_t N, const int16_t *A, const int16_t *B);
+int32_t dot_product_i16_vnni(size_t N, const int16_t *A, const int16_t *B);
+int32_t dot_product_i8_sse2(size_t N, const int8_t *A, const int8_t *B);
+int32_t dot_product_i8_avx2(size_t N, const int8_t *A, const int8_t *B);
+int32_t dot_product_i8_vnni(size_t N, const int8_t *A, const int8_t *B);
+
+enum { CHECK_MAX = 300, SMALL = 4096, LARGE = 1 << 22, PAD = 64 };
+
+static float dot_f32_c(size_t N, const float *A, const float *B) {
+  float sum = 0;
+  for (size_t i = 0; i < N; ++i) {
+    sum += A[i] * B[i];
+  }
+  return sum;
+}
+
+static double dot_f64_c(size_t N, const double *A, const double *B) {
+  double sum = 0;
+  for (size_t i = 0; i < N; ++i) {
+    sum += A[i] * B[i];
+  }
+  return sum;
+}
+
+// Wraps around like the kernels do.
+static int32_t dot_i16_c(size_t N, const int16_t *A, const int16_t *B) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < N; ++i) {
+    sum += (uint32_t)(A[i] * B[i]);
+  }
+  return (int32_t)sum;
+}
+
+static int32_t dot_i8_c(size_t N, const int8_t *A, const int8_t *B) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < N; ++i) {
+    sum += (uint32_t)(A[i] * B[i]);
+  }
+  return (int32_t)sum;
+}
+
+enum type { F32, F64, I16, I8 };
+
+struct kernel {
+  const char *name;
+  enum type type;
+  int level;  // as cpu_level_ in dot-product.s counts it
+  void *fn;
+};
+
+// The C loop of each type comes first and is the reference for the kernels after it.
+static const struct kernel kernels[] = {
+    {"f32 C loop", F32, 0, (void *)dot_f32_c},
+    {"f32 sse2", F32, 0, (void *)dot_product_sse2},
+    {"f32 fma", F32, 1, (void *)dot_product_fma},
+    {"f32 avx512", F32, 2, (void *)dot_product_avx512},
+    {"f64 C loop", F64, 0, (void *)dot_f64_c},
+    {"f64 sse2", F64, 0, (void *)dot_product_f64_sse2},
+    {"f64 fma", F64, 1, (void *)dot_product_f64_fma},
+    {"f64 avx512", F64, 2, (void *)dot_product_f64_avx512},
+    {"i16 C loop", I16, 0, (void *)dot_i16_c},
+    {"i16 sse2", I16, 0, (void *)dot_product_i16_sse2},
+    {"i16 avx2", I16, 1, (void *)dot_product_i16_avx2},
+    {"i16 vnni", I16, 3, (void *)dot_product_i16_vnni},
+    {"i8 C loop", I8, 0, (void *)dot_i8_c},
+    {"i8 sse2", I8, 0, (void *)dot_product_i8_sse2},
+    {"i8 avx2", I8, 1, (void *)dot_product_i8_avx2},
+    {"i8 vnni", I8, 3, (void *)dot_product_i8_vnni},
+};
+
+static float *f32[2];
+static double *f64[2];
+static int16_t *i16[2];
+static int8_t *i8[2];
+
+// Keeps the compiler from dropping a result that is unused.
+static volatile double sink;
+
+static int cpu_level(void) {
+  if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+    return 0;
+  }
+  if (!__builtin_cpu_supports("avx512f") || !__builtin_cpu_supports("avx512bw") ||
+      !__builtin_cpu_supports("avx512vl")) {
+    return 1;
+  }
+  return __builtin_cpu_supports("avx512vnni") ? 3 : 2;
+}
+
+// Runs k on N elements that start offset elements into its buffers.
+static double run(const struct kernel *k, size_t N, size_t offset) {
+  switch (k->type) {
+    case F32:
+      return ((float (*)(size_t, const float *, const float *))k->fn)(N, f32[0] + offset, f32[1] + offset);
+    case F64:
+      return ((double (*)(size_t, const double *, const double *))k->fn)(N, f64[0] + offset, f64[1] + offset);
+    case I16:
+      return ((int32_t(*)(size_t, const int16_t *, const int16_t *))k->fn)(N, i16[0] + offset, i16[1] + offset);
+    default:
+      return ((int32_t(*)(size_t, const int8_t *, const int8_t *))k->fn)(N, i8[0] + offset, i8[1] + offset);
+  }
+}
+
+// The inputs are small integers, so every float and double sum checked here is exact in any order.
+static int check(const struct kernel *k, const struct kernel *reference) {
+  for (size_t N = 0; N <= CHECK_MAX; ++N) {
+    for (size_t offset = 0; offset < 4; ++offset) {
+      double got = run(k, N, offset);
+      double want = run(reference, N, offset);
+      if (got != want) {
+        printf("%-12s N = %zu at offset %zu: %.0f instead of %.0f\n", k->name, N, offset, got, want);
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+static double seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+// Seconds per call on N elements, best of 5 rounds of calls.
+static double best_time(const struct kernel *k, size_t N, int calls) {
+  double best = 1e30;
+  for (int round = 0; round < 5; ++round) {
+    double start = seconds();
+    for (int i = 0; i < calls; ++i) {
+      sink = run(k, N, 0);
+    }
+    double t = (seconds() - start) / calls;
+    best = t < best ? t : best;
+  }
+  return best;
+}
+
+int main(void) {
+  for (int side = 0; side < 2; ++side) {
+    f32[side] = aligned_alloc(64, (LARGE + PAD) * sizeof(float));
+    f64[side] = aligned_alloc(64, (LARGE + PAD) * sizeof(double));
+    i16[side] = aligned_alloc(64, (LARGE + PAD) * sizeof(int16_t));
+    i8[side] = aligned_alloc(64, (LARGE + PAD) * sizeof(int8_t));
+    for (size_t i = 0; i < LARGE + PAD; ++i) {
+      int value = rand() % 256 - 128;
+      f32[side][i] = (float)(value % 16);
+      f64[side][i] = (double)(value % 16);
+      i16[side][i] = (int16_t)(value * 251);
+      i8[side][i] = (int8_t)value;
+    }
+  }
+
+  int level = cpu_level();
+  printf("%-12s %6s %16s %16s %16s\n", "kernel", "check", "4096 elements", "4M elements", "1..15 elements");
+  const struct kernel *reference = kernels;
+  for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); ++i) {
+    const struct kernel *k = &kernels[i];
+    if (k->type != reference->type) {
+      reference = k;
+    }
+    if (k->level > level) {
+      printf("%-12s not supported by this CPU\n", k->name);
+      continue;
+    }
+    int ok = check(k, reference);
+    double small = best_time(k, SMALL, 20000);
+    double large = best_time(k, LARGE, 10);
+    double tail = 0;
+    for (size_t N = 1; N < 16; ++N) {
+      tail += best_time(k, N, 200000);
+    }
+    printf("%-12s %6s %10.2f Gop/s %10.2f Gop/s %13.2f ns\n", k->name, ok ? "ok" : "FAILED", 2e-9 * SMALL / small,
+           2e-9 * LARGE / large, tail / 15 * 1e9);
+  }
+  return 0;
+}
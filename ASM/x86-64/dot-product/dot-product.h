@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// dot-product.s; each symbol is bound to the best kernel for the CPU at load time.
+float dot_product(size_t N, const float *A, const float *B);
+double dot_product_f64(size_t N, const double *A, const double *B);
+int32_t dot_product_i16(size_t N, const int16_t *A, const int16_t *B);
+int32_t dot_product_i8(size_t N, const int8_t *A, const int8_t *B);
+
+// gemm.c; matrices are row-major, ld* is the distance in floats between consecutive rows.
+
+// y = A * x for an M x N matrix A.
+void sgemv(size_t M, size_t N, const float *A, size_t lda, const float *x, float *y);
+
+// C += A * B for an M x K matrix A and a K x N matrix B, cache-blocked over packed copies of both.
+void sgemm(size_t M, size_t N, size_t K, const float *A, size_t lda, const float *B, size_t ldb, float *C,
+           size_t ldc);
+
+// Packed operands for callers that multiply by the same matrix many times: A is cut into panels of
+// SGEMM_MR rows and B into panels of SGEMM_NR columns, each stored k by k and zero-padded to full width.
+// The *_size functions give the buffer length in floats.
+#define SGEMM_MR 6
+#define SGEMM_NR 16
+
+size_t sgemm_packed_a_size(size_t M, size_t K);
+size_t sgemm_packed_b_size(size_t K, size_t N);
+void sgemm_pack_a(size_t M, size_t K, const float *A, size_t lda, float *packed);
+void sgemm_pack_b(size_t K, size_t N, const float *B, size_t ldb, float *packed);
+
+// C += A * B from sgemm_pack_a(M, K, ...) and sgemm_pack_b(K, N, ...).
+void sgemm_packed(size_t M, size_t N, size_t K, const float *packed_a, const float *packed_b, float *C, size_t ldc);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,56 +1,942 @@
     .intel_syntax noprefix
 
+# Dot products of float, double, int16 and int8 vectors:
+#   float   dot_product(size_t N, const float *A, const float *B);
+#   double  dot_product_f64(size_t N, const double *A, const double *B);
+#   int32_t dot_product_i16(size_t N, const int16_t *A, const int16_t *B);
+#   int32_t dot_product_i8(size_t N, const int8_t *A, const int8_t *B);
+# Each one is an ifunc: the dynamic loader runs the resolver once, which reads CPUID and binds the symbol to
+# the SSE2, AVX2+FMA or AVX-512 kernel. The kernels keep four independent accumulators so the adds of
+# consecutive iterations do not wait for each other, and the AVX2 and AVX-512 ones finish with a masked load
+# instead of a scalar tail. Integer sums wrap modulo 2^32.
+
+    .section .rodata
+    .balign 32
+mask_dwords_:
+    .long -1, -1, -1, -1, -1, -1, -1, -1
+    .long 0, 0, 0, 0, 0, 0, 0, 0
+mask_qwords_:
+    .quad -1, -1, -1, -1
+    .quad 0, 0, 0, 0
+
     .text
-    .global dot_product
 
+# Returns in eax 0 for SSE2 only, 1 for AVX2+FMA, 2 for AVX-512 F/BW/VL, 3 when AVX-512 VNNI is there too.
+# AVX state has to be enabled by the OS (XCR0), not just present in the CPU.
+cpu_level_:
+    push rbx
+    xor r8d, r8d
+    xor eax, eax
+    cpuid
+    cmp eax, 7
+    jb cpu_level_done_
+    mov eax, 1
+    cpuid
+    and ecx, 0x18001000                 # FMA, OSXSAVE, AVX
+    cmp ecx, 0x18001000
+    jne cpu_level_done_
+    xor ecx, ecx
+    xgetbv
+    mov r9d, eax
+    and eax, 0x6                        # XMM and YMM state
+    cmp eax, 0x6
+    jne cpu_level_done_
+    mov eax, 7
+    xor ecx, ecx
+    cpuid
+    test ebx, 0x20                      # AVX2
+    jz cpu_level_done_
+    mov r8d, 1
+    and r9d, 0xE6                       # opmask and ZMM state
+    cmp r9d, 0xE6
+    jne cpu_level_done_
+    mov eax, ebx
+    and eax, 0xC0010000                 # AVX512F, AVX512BW, AVX512VL
+    cmp eax, 0xC0010000
+    jne cpu_level_done_
+    mov r8d, 2
+    test ecx, 0x800                     # AVX512_VNNI
+    jz cpu_level_done_
+    mov r8d, 3
+cpu_level_done_:
+    mov eax, r8d
+    pop rbx
+    ret
+
+    .macro select_kernel generic, avx2, avx512, avx512_level
+    call cpu_level_
+    lea rdx, [rip + \generic]
+    lea rcx, [rip + \avx2]
+    cmp eax, 1
+    cmovae rdx, rcx
+    lea rcx, [rip + \avx512]
+    cmp eax, \avx512_level
+    cmovae rdx, rcx
+    mov rax, rdx
+    ret
+    .endm
+
+    .global dot_product
+    .type dot_product, @gnu_indirect_function
 dot_product:
+    select_kernel dot_product_sse2, dot_product_fma, dot_product_avx512, 2
+
+    .global dot_product_f64
+    .type dot_product_f64, @gnu_indirect_function
+dot_product_f64:
+    select_kernel dot_product_f64_sse2, dot_product_f64_fma, dot_product_f64_avx512, 2
+
+    .global dot_product_i16
+    .type dot_product_i16, @gnu_indirect_function
+dot_product_i16:
+    select_kernel dot_product_i16_sse2, dot_product_i16_avx2, dot_product_i16_vnni, 3
+
+    .global dot_product_i8
+    .type dot_product_i8, @gnu_indirect_function
+dot_product_i8:
+    select_kernel dot_product_i8_sse2, dot_product_i8_avx2, dot_product_i8_vnni, 3
+
+# float
+
+    .global dot_product_sse2
+    .hidden dot_product_sse2
+    .type dot_product_sse2, @function
+dot_product_sse2:
+    xorps xmm0, xmm0
+    xorps xmm1, xmm1
+    xorps xmm2, xmm2
+    xorps xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 4
+    jz f32_sse2_by4_
+
+f32_sse2_by16_:
+    movups xmm4, [rsi]
+    movups xmm5, [rsi + 16]
+    movups xmm6, [rsi + 32]
+    movups xmm7, [rsi + 48]
+    movups xmm8, [rdx]
+    movups xmm9, [rdx + 16]
+    movups xmm10, [rdx + 32]
+    movups xmm11, [rdx + 48]
+    mulps xmm4, xmm8
+    mulps xmm5, xmm9
+    mulps xmm6, xmm10
+    mulps xmm7, xmm11
+    addps xmm0, xmm4
+    addps xmm1, xmm5
+    addps xmm2, xmm6
+    addps xmm3, xmm7
+    add rsi, 64
+    add rdx, 64
+    dec rcx
+    jnz f32_sse2_by16_
+
+f32_sse2_by4_:
+    mov rcx, rdi
+    and rcx, 15
+    shr rcx, 2
+    jz f32_sse2_tail_
+
+f32_sse2_by4_loop_:
+    movups xmm4, [rsi]
+    movups xmm8, [rdx]
+    mulps xmm4, xmm8
+    addps xmm0, xmm4
+    add rsi, 16
+    add rdx, 16
+    dec rcx
+    jnz f32_sse2_by4_loop_
+
+f32_sse2_tail_:
+    and rdi, 3
+    jz f32_sse2_sum_
+
+f32_sse2_tail_loop_:
+    movss xmm4, [rsi]
+    mulss xmm4, [rdx]
+    addss xmm1, xmm4
+    add rsi, 4
+    add rdx, 4
+    dec rdi
+    jnz f32_sse2_tail_loop_
+
+f32_sse2_sum_:
+    addps xmm0, xmm1
+    addps xmm2, xmm3
+    addps xmm0, xmm2
+    movhlps xmm1, xmm0
+    addps xmm0, xmm1
+    movaps xmm1, xmm0
+    shufps xmm1, xmm1, 0x55
+    addss xmm0, xmm1
+    ret
+
+    .global dot_product_fma
+    .hidden dot_product_fma
+    .type dot_product_fma, @function
+dot_product_fma:
+    vxorps xmm0, xmm0, xmm0
+    vxorps xmm1, xmm1, xmm1
+    vxorps xmm2, xmm2, xmm2
+    vxorps xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 5
+    jz f32_fma_by8_
+
+f32_fma_by32_:
+    vmovups ymm4, [rsi]
+    vmovups ymm5, [rsi + 32]
+    vmovups ymm6, [rsi + 64]
+    vmovups ymm7, [rsi + 96]
+    vfmadd231ps ymm0, ymm4, [rdx]
+    vfmadd231ps ymm1, ymm5, [rdx + 32]
+    vfmadd231ps ymm2, ymm6, [rdx + 64]
+    vfmadd231ps ymm3, ymm7, [rdx + 96]
+    add rsi, 128
+    add rdx, 128
+    dec rcx
+    jnz f32_fma_by32_
 
-    vxorps ymm0, ymm0, ymm0
-    push rdi              
-    shr rdi, 3                     
+f32_fma_by8_:
+    mov rcx, rdi
+    and rcx, 31
+    shr rcx, 3
+    jz f32_fma_tail_
 
-loop_:
+f32_fma_by8_loop_:
+    vmovups ymm4, [rsi]
+    vfmadd231ps ymm0, ymm4, [rdx]
+    add rsi, 32
+    add rdx, 32
+    dec rcx
+    jnz f32_fma_by8_loop_
+
+f32_fma_tail_:
+    and rdi, 7
+    jz f32_fma_sum_
+    lea rax, [rip + mask_dwords_]
+    neg rdi
+    vmovdqu ymm7, [rax + rdi * 4 + 32]  # first N % 8 lanes set
+    vmaskmovps ymm4, ymm7, [rsi]
+    vmaskmovps ymm5, ymm7, [rdx]
+    vfmadd231ps ymm1, ymm4, ymm5
+
+f32_fma_sum_:
+    vaddps ymm0, ymm0, ymm1
+    vaddps ymm2, ymm2, ymm3
+    vaddps ymm0, ymm0, ymm2
 
-    jz rem_
+f32_sum_ymm0_:
+    vextractf128 xmm1, ymm0, 1
+    vaddps xmm0, xmm0, xmm1
+    vmovhlps xmm1, xmm0, xmm0
+    vaddps xmm0, xmm0, xmm1
+    vmovshdup xmm1, xmm0
+    vaddss xmm0, xmm0, xmm1
+    vzeroupper
+    ret
+
+    .global dot_product_avx512
+    .hidden dot_product_avx512
+    .type dot_product_avx512, @function
+dot_product_avx512:
+    vxorps xmm0, xmm0, xmm0
+    vxorps xmm1, xmm1, xmm1
+    vxorps xmm2, xmm2, xmm2
+    vxorps xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 6
+    jz f32_avx512_by16_
+
+f32_avx512_by64_:
+    vmovups zmm4, [rsi]
+    vmovups zmm5, [rsi + 64]
+    vmovups zmm6, [rsi + 128]
+    vmovups zmm7, [rsi + 192]
+    vfmadd231ps zmm0, zmm4, [rdx]
+    vfmadd231ps zmm1, zmm5, [rdx + 64]
+    vfmadd231ps zmm2, zmm6, [rdx + 128]
+    vfmadd231ps zmm3, zmm7, [rdx + 192]
+    add rsi, 256
+    add rdx, 256
+    dec rcx
+    jnz f32_avx512_by64_
 
-    vmovups ymm1, [rsi]
-    vmovups ymm2, [rdx]
+f32_avx512_by16_:
+    mov rcx, rdi
+    and rcx, 63
+    shr rcx, 4
+    jz f32_avx512_tail_
 
-    vmulps ymm1, ymm1, ymm2
+f32_avx512_by16_loop_:
+    vmovups zmm4, [rsi]
+    vfmadd231ps zmm0, zmm4, [rdx]
+    add rsi, 64
+    add rdx, 64
+    dec rcx
+    jnz f32_avx512_by16_loop_
+
+f32_avx512_tail_:
+    mov ecx, edi
+    and ecx, 15
+    jz f32_avx512_sum_
+    mov eax, 1
+    shl eax, cl
+    dec eax
+    kmovw k1, eax
+    vmovups zmm4{k1}{z}, [rsi]
+    vmovups zmm5{k1}{z}, [rdx]
+    vfmadd231ps zmm1, zmm4, zmm5
+
+f32_avx512_sum_:
+    vaddps zmm0, zmm0, zmm1
+    vaddps zmm2, zmm2, zmm3
+    vaddps zmm0, zmm0, zmm2
+    vextractf64x4 ymm1, zmm0, 1
     vaddps ymm0, ymm0, ymm1
+    jmp f32_sum_ymm0_
+
+# double
 
+    .global dot_product_f64_sse2
+    .hidden dot_product_f64_sse2
+    .type dot_product_f64_sse2, @function
+dot_product_f64_sse2:
+    xorpd xmm0, xmm0
+    xorpd xmm1, xmm1
+    xorpd xmm2, xmm2
+    xorpd xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 3
+    jz f64_sse2_by2_
+
+f64_sse2_by8_:
+    movupd xmm4, [rsi]
+    movupd xmm5, [rsi + 16]
+    movupd xmm6, [rsi + 32]
+    movupd xmm7, [rsi + 48]
+    movupd xmm8, [rdx]
+    movupd xmm9, [rdx + 16]
+    movupd xmm10, [rdx + 32]
+    movupd xmm11, [rdx + 48]
+    mulpd xmm4, xmm8
+    mulpd xmm5, xmm9
+    mulpd xmm6, xmm10
+    mulpd xmm7, xmm11
+    addpd xmm0, xmm4
+    addpd xmm1, xmm5
+    addpd xmm2, xmm6
+    addpd xmm3, xmm7
+    add rsi, 64
+    add rdx, 64
+    dec rcx
+    jnz f64_sse2_by8_
+
+f64_sse2_by2_:
+    mov rcx, rdi
+    and rcx, 7
+    shr rcx, 1
+    jz f64_sse2_tail_
+
+f64_sse2_by2_loop_:
+    movupd xmm4, [rsi]
+    movupd xmm8, [rdx]
+    mulpd xmm4, xmm8
+    addpd xmm0, xmm4
+    add rsi, 16
+    add rdx, 16
+    dec rcx
+    jnz f64_sse2_by2_loop_
+
+f64_sse2_tail_:
+    test rdi, 1
+    jz f64_sse2_sum_
+    movsd xmm4, [rsi]
+    mulsd xmm4, [rdx]
+    addsd xmm1, xmm4
+
+f64_sse2_sum_:
+    addpd xmm0, xmm1
+    addpd xmm2, xmm3
+    addpd xmm0, xmm2
+    movapd xmm1, xmm0
+    unpckhpd xmm1, xmm1
+    addsd xmm0, xmm1
+    ret
+
+    .global dot_product_f64_fma
+    .hidden dot_product_f64_fma
+    .type dot_product_f64_fma, @function
+dot_product_f64_fma:
+    vxorpd xmm0, xmm0, xmm0
+    vxorpd xmm1, xmm1, xmm1
+    vxorpd xmm2, xmm2, xmm2
+    vxorpd xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 4
+    jz f64_fma_by4_
+
+f64_fma_by16_:
+    vmovupd ymm4, [rsi]
+    vmovupd ymm5, [rsi + 32]
+    vmovupd ymm6, [rsi + 64]
+    vmovupd ymm7, [rsi + 96]
+    vfmadd231pd ymm0, ymm4, [rdx]
+    vfmadd231pd ymm1, ymm5, [rdx + 32]
+    vfmadd231pd ymm2, ymm6, [rdx + 64]
+    vfmadd231pd ymm3, ymm7, [rdx + 96]
+    add rsi, 128
+    add rdx, 128
+    dec rcx
+    jnz f64_fma_by16_
+
+f64_fma_by4_:
+    mov rcx, rdi
+    and rcx, 15
+    shr rcx, 2
+    jz f64_fma_tail_
+
+f64_fma_by4_loop_:
+    vmovupd ymm4, [rsi]
+    vfmadd231pd ymm0, ymm4, [rdx]
     add rsi, 32
     add rdx, 32
+    dec rcx
+    jnz f64_fma_by4_loop_
 
-    dec rdi
-    jmp loop_
+f64_fma_tail_:
+    and rdi, 3
+    jz f64_fma_sum_
+    lea rax, [rip + mask_qwords_]
+    neg rdi
+    vmovdqu ymm7, [rax + rdi * 8 + 32]  # first N % 4 lanes set
+    vmaskmovpd ymm4, ymm7, [rsi]
+    vmaskmovpd ymm5, ymm7, [rdx]
+    vfmadd231pd ymm1, ymm4, ymm5
 
-rem_:
+f64_fma_sum_:
+    vaddpd ymm0, ymm0, ymm1
+    vaddpd ymm2, ymm2, ymm3
+    vaddpd ymm0, ymm0, ymm2
 
-    pop rdi
-    and rdi, 7
+f64_sum_ymm0_:
+    vextractf128 xmm1, ymm0, 1
+    vaddpd xmm0, xmm0, xmm1
+    vunpckhpd xmm1, xmm0, xmm0
+    vaddsd xmm0, xmm0, xmm1
+    vzeroupper
+    ret
 
-    jz ans_
+    .global dot_product_f64_avx512
+    .hidden dot_product_f64_avx512
+    .type dot_product_f64_avx512, @function
+dot_product_f64_avx512:
+    vxorpd xmm0, xmm0, xmm0
+    vxorpd xmm1, xmm1, xmm1
+    vxorpd xmm2, xmm2, xmm2
+    vxorpd xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 5
+    jz f64_avx512_by8_
 
-loop_2_ :
+f64_avx512_by32_:
+    vmovupd zmm4, [rsi]
+    vmovupd zmm5, [rsi + 64]
+    vmovupd zmm6, [rsi + 128]
+    vmovupd zmm7, [rsi + 192]
+    vfmadd231pd zmm0, zmm4, [rdx]
+    vfmadd231pd zmm1, zmm5, [rdx + 64]
+    vfmadd231pd zmm2, zmm6, [rdx + 128]
+    vfmadd231pd zmm3, zmm7, [rdx + 192]
+    add rsi, 256
+    add rdx, 256
+    dec rcx
+    jnz f64_avx512_by32_
 
-    movss xmm1, [rsi]
-    movss xmm2, [rdx]
-    mulss xmm1, xmm2                
-    addss xmm0, xmm1               
+f64_avx512_by8_:
+    mov rcx, rdi
+    and rcx, 31
+    shr rcx, 3
+    jz f64_avx512_tail_
 
-    
-    add rsi, 4                     
-    add rdx, 4
+f64_avx512_by8_loop_:
+    vmovupd zmm4, [rsi]
+    vfmadd231pd zmm0, zmm4, [rdx]
+    add rsi, 64
+    add rdx, 64
+    dec rcx
+    jnz f64_avx512_by8_loop_
+
+f64_avx512_tail_:
+    mov ecx, edi
+    and ecx, 7
+    jz f64_avx512_sum_
+    mov eax, 1
+    shl eax, cl
+    dec eax
+    kmovw k1, eax
+    vmovupd zmm4{k1}{z}, [rsi]
+    vmovupd zmm5{k1}{z}, [rdx]
+    vfmadd231pd zmm1, zmm4, zmm5
+
+f64_avx512_sum_:
+    vaddpd zmm0, zmm0, zmm1
+    vaddpd zmm2, zmm2, zmm3
+    vaddpd zmm0, zmm0, zmm2
+    vextractf64x4 ymm1, zmm0, 1
+    vaddpd ymm0, ymm0, ymm1
+    jmp f64_sum_ymm0_
+
+# int16: pmaddwd multiplies neighbouring pairs and adds them into one int32 lane, vpdpwssd also accumulates.
+
+    .global dot_product_i16_sse2
+    .hidden dot_product_i16_sse2
+    .type dot_product_i16_sse2, @function
+dot_product_i16_sse2:
+    pxor xmm0, xmm0
+    pxor xmm1, xmm1
+    pxor xmm2, xmm2
+    pxor xmm3, xmm3
+    xor r8d, r8d
+    mov rcx, rdi
+    shr rcx, 5
+    jz i16_sse2_by8_
 
+i16_sse2_by32_:
+    movdqu xmm4, [rsi]
+    movdqu xmm5, [rsi + 16]
+    movdqu xmm6, [rsi + 32]
+    movdqu xmm7, [rsi + 48]
+    movdqu xmm8, [rdx]
+    movdqu xmm9, [rdx + 16]
+    movdqu xmm10, [rdx + 32]
+    movdqu xmm11, [rdx + 48]
+    pmaddwd xmm4, xmm8
+    pmaddwd xmm5, xmm9
+    pmaddwd xmm6, xmm10
+    pmaddwd xmm7, xmm11
+    paddd xmm0, xmm4
+    paddd xmm1, xmm5
+    paddd xmm2, xmm6
+    paddd xmm3, xmm7
+    add rsi, 64
+    add rdx, 64
+    dec rcx
+    jnz i16_sse2_by32_
+
+i16_sse2_by8_:
+    mov rcx, rdi
+    and rcx, 31
+    shr rcx, 3
+    jz i16_sse2_tail_
+
+i16_sse2_by8_loop_:
+    movdqu xmm4, [rsi]
+    movdqu xmm8, [rdx]
+    pmaddwd xmm4, xmm8
+    paddd xmm0, xmm4
+    add rsi, 16
+    add rdx, 16
+    dec rcx
+    jnz i16_sse2_by8_loop_
+
+i16_sse2_tail_:
+    and rdi, 7
+    jz i32_sse2_sum_
+
+i16_sse2_tail_loop_:
+    movsx eax, word ptr [rsi]
+    movsx ecx, word ptr [rdx]
+    imul eax, ecx
+    add r8d, eax
+    add rsi, 2
+    add rdx, 2
     dec rdi
-    jnz loop_2_
+    jnz i16_sse2_tail_loop_
+
+# Adds the four accumulators and r8d into eax.
+i32_sse2_sum_:
+    paddd xmm0, xmm1
+    paddd xmm2, xmm3
+    paddd xmm0, xmm2
+    pshufd xmm1, xmm0, 0x4E
+    paddd xmm0, xmm1
+    pshufd xmm1, xmm0, 0xB1
+    paddd xmm0, xmm1
+    movd eax, xmm0
+    add eax, r8d
+    ret
+
+    .global dot_product_i16_avx2
+    .hidden dot_product_i16_avx2
+    .type dot_product_i16_avx2, @function
+dot_product_i16_avx2:
+    vpxor xmm0, xmm0, xmm0
+    vpxor xmm1, xmm1, xmm1
+    vpxor xmm2, xmm2, xmm2
+    vpxor xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 6
+    jz i16_avx2_by16_
+
+i16_avx2_by64_:
+    vmovdqu ymm4, [rsi]
+    vmovdqu ymm5, [rsi + 32]
+    vmovdqu ymm6, [rsi + 64]
+    vmovdqu ymm7, [rsi + 96]
+    vpmaddwd ymm4, ymm4, [rdx]
+    vpmaddwd ymm5, ymm5, [rdx + 32]
+    vpmaddwd ymm6, ymm6, [rdx + 64]
+    vpmaddwd ymm7, ymm7, [rdx + 96]
+    vpaddd ymm0, ymm0, ymm4
+    vpaddd ymm1, ymm1, ymm5
+    vpaddd ymm2, ymm2, ymm6
+    vpaddd ymm3, ymm3, ymm7
+    add rsi, 128
+    add rdx, 128
+    dec rcx
+    jnz i16_avx2_by64_
+
+i16_avx2_by16_:
+    mov rcx, rdi
+    and rcx, 63
+    shr rcx, 4
+    jz i16_avx2_tail_
+
+i16_avx2_by16_loop_:
+    vmovdqu ymm4, [rsi]
+    vpmaddwd ymm4, ymm4, [rdx]
+    vpaddd ymm0, ymm0, ymm4
+    add rsi, 32
+    add rdx, 32
+    dec rcx
+    jnz i16_avx2_by16_loop_
 
-ans_:
+# vpmaskmovd loads the whole pairs of words; an odd last word goes alone into the low half of a dword.
+i16_avx2_tail_:
+    and rdi, 15
+    jz i32_avx2_sum_
+    lea rax, [rip + mask_dwords_]
+    mov rcx, rdi
+    shr rcx, 1
+    neg rcx
+    vmovdqu ymm7, [rax + rcx * 4 + 32]  # first N % 16 / 2 lanes set
+    vpmaskmovd ymm4, ymm7, [rsi]
+    vpmaskmovd ymm5, ymm7, [rdx]
+    vpmaddwd ymm4, ymm4, ymm5
+    vpaddd ymm1, ymm1, ymm4
+    test edi, 1
+    jz i32_avx2_sum_
+    movzx eax, word ptr [rsi + rdi * 2 - 2]
+    movzx ecx, word ptr [rdx + rdi * 2 - 2]
+    vmovd xmm4, eax
+    vmovd xmm5, ecx
+    vpmaddwd xmm4, xmm4, xmm5
+    vpaddd ymm2, ymm2, ymm4
 
-    vhaddps ymm0, ymm0, ymm0       
-    vhaddps ymm0, ymm0, ymm0
-    vextractf128 xmm1, ymm0, 1     
-    addss xmm0, xmm1                 
+# Adds the four accumulators into eax.
+i32_avx2_sum_:
+    vpaddd ymm0, ymm0, ymm1
+    vpaddd ymm2, ymm2, ymm3
+    vpaddd ymm0, ymm0, ymm2
 
+i32_sum_ymm0_:
+    vextracti128 xmm1, ymm0, 1
+    vpaddd xmm0, xmm0, xmm1
+    vpshufd xmm1, xmm0, 0x4E
+    vpaddd xmm0, xmm0, xmm1
+    vpshufd xmm1, xmm0, 0xB1
+    vpaddd xmm0, xmm0, xmm1
+    vmovd eax, xmm0
+    vzeroupper
     ret
+
+    .global dot_product_i16_vnni
+    .hidden dot_product_i16_vnni
+    .type dot_product_i16_vnni, @function
+dot_product_i16_vnni:
+    vpxor xmm0, xmm0, xmm0
+    vpxor xmm1, xmm1, xmm1
+    vpxor xmm2, xmm2, xmm2
+    vpxor xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 7
+    jz i16_vnni_by32_
+
+i16_vnni_by128_:
+    vmovdqu64 zmm4, [rsi]
+    vmovdqu64 zmm5, [rsi + 64]
+    vmovdqu64 zmm6, [rsi + 128]
+    vmovdqu64 zmm7, [rsi + 192]
+    vpdpwssd zmm0, zmm4, [rdx]
+    vpdpwssd zmm1, zmm5, [rdx + 64]
+    vpdpwssd zmm2, zmm6, [rdx + 128]
+    vpdpwssd zmm3, zmm7, [rdx + 192]
+    add rsi, 256
+    add rdx, 256
+    dec rcx
+    jnz i16_vnni_by128_
+
+i16_vnni_by32_:
+    mov rcx, rdi
+    and rcx, 127
+    shr rcx, 5
+    jz i16_vnni_tail_
+
+i16_vnni_by32_loop_:
+    vmovdqu64 zmm4, [rsi]
+    vpdpwssd zmm0, zmm4, [rdx]
+    add rsi, 64
+    add rdx, 64
+    dec rcx
+    jnz i16_vnni_by32_loop_
+
+i16_vnni_tail_:
+    mov ecx, edi
+    and ecx, 31
+    jz i32_avx512_sum_
+    mov eax, 1
+    shl eax, cl
+    dec eax
+    kmovd k1, eax
+    vmovdqu16 zmm4{k1}{z}, [rsi]
+    vmovdqu16 zmm5{k1}{z}, [rdx]
+    vpdpwssd zmm1, zmm4, zmm5
+
+i32_avx512_sum_:
+    vpaddd zmm0, zmm0, zmm1
+    vpaddd zmm2, zmm2, zmm3
+    vpaddd zmm0, zmm0, zmm2
+    vextracti64x4 ymm1, zmm0, 1
+    vpaddd ymm0, ymm0, ymm1
+    jmp i32_sum_ymm0_
+
+# int8: both sides are signed, which the byte form vpdpbusd (unsigned x signed) does not cover, so the bytes
+# are sign-extended to words and go through the int16 path.
+
+    .global dot_product_i8_sse2
+    .hidden dot_product_i8_sse2
+    .type dot_product_i8_sse2, @function
+dot_product_i8_sse2:
+    pxor xmm0, xmm0
+    pxor xmm1, xmm1
+    pxor xmm2, xmm2
+    pxor xmm3, xmm3
+    xor r8d, r8d
+    mov rcx, rdi
+    shr rcx, 4
+    jz i8_sse2_by8_
+
+i8_sse2_by16_:
+    movdqu xmm4, [rsi]
+    movdqu xmm8, [rdx]
+    movdqa xmm5, xmm4
+    movdqa xmm9, xmm8
+    punpcklbw xmm4, xmm4
+    punpckhbw xmm5, xmm5
+    punpcklbw xmm8, xmm8
+    punpckhbw xmm9, xmm9
+    psraw xmm4, 8
+    psraw xmm5, 8
+    psraw xmm8, 8
+    psraw xmm9, 8
+    pmaddwd xmm4, xmm8
+    pmaddwd xmm5, xmm9
+    paddd xmm0, xmm4
+    paddd xmm1, xmm5
+    add rsi, 16
+    add rdx, 16
+    dec rcx
+    jnz i8_sse2_by16_
+
+i8_sse2_by8_:
+    test rdi, 8
+    jz i8_sse2_tail_
+    movq xmm4, [rsi]
+    movq xmm8, [rdx]
+    punpcklbw xmm4, xmm4
+    punpcklbw xmm8, xmm8
+    psraw xmm4, 8
+    psraw xmm8, 8
+    pmaddwd xmm4, xmm8
+    paddd xmm2, xmm4
+    add rsi, 8
+    add rdx, 8
+
+i8_sse2_tail_:
+    and rdi, 7
+    jz i32_sse2_sum_
+
+i8_sse2_tail_loop_:
+    movsx eax, byte ptr [rsi]
+    movsx ecx, byte ptr [rdx]
+    imul eax, ecx
+    add r8d, eax
+    inc rsi
+    inc rdx
+    dec rdi
+    jnz i8_sse2_tail_loop_
+    jmp i32_sse2_sum_
+
+    .global dot_product_i8_avx2
+    .hidden dot_product_i8_avx2
+    .type dot_product_i8_avx2, @function
+dot_product_i8_avx2:
+    vpxor xmm0, xmm0, xmm0
+    vpxor xmm1, xmm1, xmm1
+    vpxor xmm2, xmm2, xmm2
+    vpxor xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 6
+    jz i8_avx2_by16_
+
+i8_avx2_by64_:
+    vpmovsxbw ymm4, [rsi]
+    vpmovsxbw ymm5, [rsi + 16]
+    vpmovsxbw ymm6, [rsi + 32]
+    vpmovsxbw ymm7, [rsi + 48]
+    vpmovsxbw ymm8, [rdx]
+    vpmovsxbw ymm9, [rdx + 16]
+    vpmovsxbw ymm10, [rdx + 32]
+    vpmovsxbw ymm11, [rdx + 48]
+    vpmaddwd ymm4, ymm4, ymm8
+    vpmaddwd ymm5, ymm5, ymm9
+    vpmaddwd ymm6, ymm6, ymm10
+    vpmaddwd ymm7, ymm7, ymm11
+    vpaddd ymm0, ymm0, ymm4
+    vpaddd ymm1, ymm1, ymm5
+    vpaddd ymm2, ymm2, ymm6
+    vpaddd ymm3, ymm3, ymm7
+    add rsi, 64
+    add rdx, 64
+    dec rcx
+    jnz i8_avx2_by64_
+
+i8_avx2_by16_:
+    mov rcx, rdi
+    and rcx, 63
+    shr rcx, 4
+    jz i8_avx2_tail_
+
+i8_avx2_by16_loop_:
+    vpmovsxbw ymm4, [rsi]
+    vpmovsxbw ymm8, [rdx]
+    vpmaddwd ymm4, ymm4, ymm8
+    vpaddd ymm0, ymm0, ymm4
+    add rsi, 16
+    add rdx, 16
+    dec rcx
+    jnz i8_avx2_by16_loop_
+
+# vpmaskmovd loads the whole dwords; the last N % 4 bytes are gathered into one dword of each side, at the
+# same positions, and go through the same widening multiply.
+i8_avx2_tail_:
+    and rdi, 15
+    jz i32_avx2_sum_
+    lea rax, [rip + mask_dwords_]
+    mov rcx, rdi
+    shr rcx, 2
+    neg rcx
+    vmovdqu xmm7, [rax + rcx * 4 + 32]  # first N % 16 / 4 lanes set
+    vpmaskmovd xmm4, xmm7, [rsi]
+    vpmaskmovd xmm8, xmm7, [rdx]
+    vpmovsxbw ymm4, xmm4
+    vpmovsxbw ymm8, xmm8
+    vpmaddwd ymm4, ymm4, ymm8
+    vpaddd ymm1, ymm1, ymm4
+    test edi, 3
+    jz i32_avx2_sum_
+    mov rcx, rdi
+    and rcx, -4
+    add rsi, rcx
+    add rdx, rcx
+    xor eax, eax
+    xor ecx, ecx
+    test edi, 1
+    jz i8_avx2_tail_pair_
+    movzx eax, byte ptr [rsi]
+    movzx ecx, byte ptr [rdx]
+    inc rsi
+    inc rdx
+
+i8_avx2_tail_pair_:
+    test edi, 2
+    jz i8_avx2_tail_sum_
+    movzx r9d, word ptr [rsi]
+    shl r9d, 8
+    or eax, r9d
+    movzx r9d, word ptr [rdx]
+    shl r9d, 8
+    or ecx, r9d
+
+i8_avx2_tail_sum_:
+    vmovd xmm4, eax
+    vmovd xmm8, ecx
+    vpmovsxbw xmm4, xmm4
+    vpmovsxbw xmm8, xmm8
+    vpmaddwd xmm4, xmm4, xmm8
+    vpaddd ymm2, ymm2, ymm4
+    jmp i32_avx2_sum_
+
+    .global dot_product_i8_vnni
+    .hidden dot_product_i8_vnni
+    .type dot_product_i8_vnni, @function
+dot_product_i8_vnni:
+    vpxor xmm0, xmm0, xmm0
+    vpxor xmm1, xmm1, xmm1
+    vpxor xmm2, xmm2, xmm2
+    vpxor xmm3, xmm3, xmm3
+    mov rcx, rdi
+    shr rcx, 7
+    jz i8_vnni_by32_
+
+i8_vnni_by128_:
+    vpmovsxbw zmm4, [rsi]
+    vpmovsxbw zmm5, [rsi + 32]
+    vpmovsxbw zmm6, [rsi + 64]
+    vpmovsxbw zmm7, [rsi + 96]
+    vpmovsxbw zmm8, [rdx]
+    vpmovsxbw zmm9, [rdx + 32]
+    vpmovsxbw zmm10, [rdx + 64]
+    vpmovsxbw zmm11, [rdx + 96]
+    vpdpwssd zmm0, zmm4, zmm8
+    vpdpwssd zmm1, zmm5, zmm9
+    vpdpwssd zmm2, zmm6, zmm10
+    vpdpwssd zmm3, zmm7, zmm11
+    add rsi, 128
+    add rdx, 128
+    dec rcx
+    jnz i8_vnni_by128_
+
+i8_vnni_by32_:
+    mov rcx, rdi
+    and rcx, 127
+    shr rcx, 5
+    jz i8_vnni_tail_
+
+i8_vnni_by32_loop_:
+    vpmovsxbw zmm4, [rsi]
+    vpmovsxbw zmm8, [rdx]
+    vpdpwssd zmm0, zmm4, zmm8
+    add rsi, 32
+    add rdx, 32
+    dec rcx
+    jnz i8_vnni_by32_loop_
+
+i8_vnni_tail_:
+    mov ecx, edi
+    and ecx, 31
+    jz i32_avx512_sum_
+    mov eax, 1
+    shl eax, cl
+    dec eax
+    kmovd k1, eax
+    vmovdqu8 ymm4{k1}{z}, [rsi]
+    vmovdqu8 ymm8{k1}{z}, [rdx]
+    vpmovsxbw zmm4, ymm4
+    vpmovsxbw zmm8, ymm8
+    vpdpwssd zmm1, zmm4, zmm8
+    jmp i32_avx512_sum_
+
+    .section .note.GNU-stack, "", @progbits
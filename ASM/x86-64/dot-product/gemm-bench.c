@@ -0,0 +1,154 @@
+// GFLOP/s of sgemv and sgemm against the same products done one dot_product per output element: a row of A
+// against x for sgemv, a row of A against a column of B, taken from a transposed copy, for sgemm. Every
+// result is checked against the dot_product one before it is timed.
+//
+//   gcc -O2 gemm-bench.c gemm.c dot-product.s -o gemm-bench && ./gemm-bench
+//
+// The transposition is done once, outside the timing, which favours the dot_product side.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "dot-product.h"
+
+// Keeps the compiler from dropping a result that is unused.
+static volatile float sink;
+
+static double seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+static float *random_matrix(size_t rows, size_t cols) {
+  float *m = malloc(rows * cols * sizeof(float));
+  for (size_t i = 0; i < rows * cols; ++i) {
+    m[i] = (float)rand() / (float)RAND_MAX - 0.5f;
+  }
+  return m;
+}
+
+// Plain comparisons, so the bench needs no libm.
+static double smaller(double a, double b) {
+  return a < b ? a : b;
+}
+
+static double larger(double a, double b) {
+  return a > b ? a : b;
+}
+
+static double magnitude(double x) {
+  return x < 0 ? -x : x;
+}
+
+// Largest difference relative to the magnitude of the expected values.
+static double max_error(size_t n, const float *got, const float *want) {
+  double error = 0, scale = 1e-30;
+  for (size_t i = 0; i < n; ++i) {
+    error = larger(error, magnitude((double)got[i] - (double)want[i]));
+    scale = larger(scale, magnitude((double)want[i]));
+  }
+  return error / scale;
+}
+
+static void dot_gemv(size_t M, size_t N, const float *A, const float *x, float *y) {
+  for (size_t i = 0; i < M; ++i) {
+    y[i] = dot_product(N, A + i * N, x);
+  }
+}
+
+// C = A * B with Bt the transpose of B.
+static void dot_gemm(size_t M, size_t N, size_t K, const float *A, const float *Bt, float *C) {
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      C[i * N + j] = dot_product(K, A + i * K, Bt + j * K);
+    }
+  }
+}
+
+static void bench_sgemv(size_t M, size_t N) {
+  float *A = random_matrix(M, N);
+  float *x = random_matrix(N, 1);
+  float *y = malloc(M * sizeof(float));
+  float *want = malloc(M * sizeof(float));
+  dot_gemv(M, N, A, x, want);
+  sgemv(M, N, A, N, x, y);
+  double error = max_error(M, y, want);
+
+  int calls = (int)(4e8 / ((double)M * (double)N)) + 1;
+  double best_sgemv = 1e30, best_dot = 1e30;
+  for (int round = 0; round < 5; ++round) {
+    double start = seconds();
+    for (int c = 0; c < calls; ++c) {
+      sgemv(M, N, A, N, x, y);
+      sink = y[0];
+    }
+    best_sgemv = smaller(best_sgemv, (seconds() - start) / calls);
+    start = seconds();
+    for (int c = 0; c < calls; ++c) {
+      dot_gemv(M, N, A, x, y);
+      sink = y[0];
+    }
+    best_dot = smaller(best_dot, (seconds() - start) / calls);
+  }
+  double flop = 2.0 * (double)M * (double)N;
+  printf("sgemv %5zu x %-5zu  sgemv %6.2f GFLOP/s   dot_product rows %6.2f GFLOP/s   %4.2fx   error %.1e\n", M, N,
+         flop / best_sgemv * 1e-9, flop / best_dot * 1e-9, best_dot / best_sgemv, error);
+  free(A);
+  free(x);
+  free(y);
+  free(want);
+}
+
+static void bench_sgemm(size_t n) {
+  float *A = random_matrix(n, n);
+  float *B = random_matrix(n, n);
+  float *Bt = malloc(n * n * sizeof(float));
+  for (size_t k = 0; k < n; ++k) {
+    for (size_t j = 0; j < n; ++j) {
+      Bt[j * n + k] = B[k * n + j];
+    }
+  }
+  float *C = calloc(n * n, sizeof(float));
+  float *want = malloc(n * n * sizeof(float));
+  dot_gemm(n, n, n, A, Bt, want);
+  sgemm(n, n, n, A, n, B, n, C, n);
+  double error = max_error(n * n, C, want);
+
+  int calls = (int)(2e9 / ((double)n * (double)n * (double)n)) + 1;
+  double best_sgemm = 1e30, best_dot = 1e30;
+  for (int round = 0; round < 3; ++round) {
+    double start = seconds();
+    for (int c = 0; c < calls; ++c) {
+      sgemm(n, n, n, A, n, B, n, C, n);
+      sink = C[0];
+    }
+    best_sgemm = smaller(best_sgemm, (seconds() - start) / calls);
+    start = seconds();
+    for (int c = 0; c < calls; ++c) {
+      dot_gemm(n, n, n, A, Bt, C);
+      sink = C[0];
+    }
+    best_dot = smaller(best_dot, (seconds() - start) / calls);
+  }
+  double flop = 2.0 * (double)n * (double)n * (double)n;
+  printf("sgemm %5zu cubed    sgemm %6.2f GFLOP/s   dot_product rows %6.2f GFLOP/s   %4.2fx   error %.1e\n", n,
+         flop / best_sgemm * 1e-9, flop / best_dot * 1e-9, best_dot / best_sgemm, error);
+  free(A);
+  free(B);
+  free(Bt);
+  free(C);
+  free(want);
+}
+
+int main(void) {
+  bench_sgemv(64, 64);
+  bench_sgemv(1024, 1024);
+  bench_sgemv(4096, 4096);
+  bench_sgemv(100000, 13);
+  bench_sgemm(64);
+  bench_sgemm(256);
+  bench_sgemm(1024);
+  return 0;
+}
@@ -0,0 +1,273 @@
+#include "dot-product.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define GEMM_HAS_FMA_KERNELS
+#endif
+
+// Blocking of sgemm: a KC x NC block of packed B stays in L3, an MC x KC block of packed A in L2, and one
+// KC x SGEMM_NR panel of B in L1 while the micro-kernel walks down the panels of A.
+enum { KC = 256, MC = 20 * SGEMM_MR, NC = 128 * SGEMM_NR };
+
+#ifdef GEMM_HAS_FMA_KERNELS
+// Set once at load time, before any thread can call in, and only read afterwards. A constructor that runs
+// earlier and calls sgemm gets the scalar kernels, which are slower but correct.
+static int fma_kernels;
+
+__attribute__((constructor)) static void detect_fma(void) {
+  __builtin_cpu_init();
+  fma_kernels = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+static int has_fma(void) {
+#ifdef GEMM_HAS_FMA_KERNELS
+  return fma_kernels;
+#else
+  return 0;
+#endif
+}
+
+// sgemv
+
+static void sgemv_rows(size_t M, size_t N, const float *A, size_t lda, const float *x, float *y) {
+  for (size_t i = 0; i < M; ++i) {
+    y[i] = dot_product(N, A + i * lda, x);
+  }
+}
+
+#ifdef GEMM_HAS_FMA_KERNELS
+// Sums of the eight lanes of a, b, c and d, in that order.
+__attribute__((target("avx2,fma"))) static __m128 sum4(__m256 a, __m256 b, __m256 c, __m256 d) {
+  __m256 ab = _mm256_hadd_ps(a, b);
+  __m256 cd = _mm256_hadd_ps(c, d);
+  __m256 abcd = _mm256_hadd_ps(ab, cd);
+  return _mm_add_ps(_mm256_castps256_ps128(abcd), _mm256_extractf128_ps(abcd, 1));
+}
+
+// Four rows at a time: each load of x feeds four FMAs, and the four rows share one horizontal reduction.
+__attribute__((target("avx2,fma"))) static void sgemv_fma(size_t M, size_t N, const float *A, size_t lda,
+                                                          const float *x, float *y) {
+  static const int32_t kMask[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+  __m256i tail = _mm256_loadu_si256((const __m256i *)(kMask + 8 - N % 8));
+  size_t full = N - N % 8;
+  size_t i = 0;
+  for (; i + 4 <= M; i += 4) {
+    const float *r0 = A + i * lda;
+    const float *r1 = r0 + lda;
+    const float *r2 = r1 + lda;
+    const float *r3 = r2 + lda;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    for (size_t j = 0; j < full; j += 8) {
+      __m256 v = _mm256_loadu_ps(x + j);
+      acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(r0 + j), v, acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(r1 + j), v, acc1);
+      acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(r2 + j), v, acc2);
+      acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(r3 + j), v, acc3);
+    }
+    if (full < N) {
+      __m256 v = _mm256_maskload_ps(x + full, tail);
+      acc0 = _mm256_fmadd_ps(_mm256_maskload_ps(r0 + full, tail), v, acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_maskload_ps(r1 + full, tail), v, acc1);
+      acc2 = _mm256_fmadd_ps(_mm256_maskload_ps(r2 + full, tail), v, acc2);
+      acc3 = _mm256_fmadd_ps(_mm256_maskload_ps(r3 + full, tail), v, acc3);
+    }
+    _mm_storeu_ps(y + i, sum4(acc0, acc1, acc2, acc3));
+  }
+  sgemv_rows(M - i, N, A + i * lda, lda, x, y + i);
+}
+#endif
+
+void sgemv(size_t M, size_t N, const float *A, size_t lda, const float *x, float *y) {
+#ifdef GEMM_HAS_FMA_KERNELS
+  if (has_fma()) {
+    sgemv_fma(M, N, A, lda, x, y);
+    return;
+  }
+#endif
+  sgemv_rows(M, N, A, lda, x, y);
+}
+
+// packing
+
+static size_t round_up(size_t n, size_t to) {
+  return (n + to - 1) / to * to;
+}
+
+size_t sgemm_packed_a_size(size_t M, size_t K) {
+  return round_up(M, SGEMM_MR) * K;
+}
+
+size_t sgemm_packed_b_size(size_t K, size_t N) {
+  return round_up(N, SGEMM_NR) * K;
+}
+
+void sgemm_pack_a(size_t M, size_t K, const float *A, size_t lda, float *packed) {
+  for (size_t i = 0; i < M; i += SGEMM_MR) {
+    size_t rows = M - i < SGEMM_MR ? M - i : SGEMM_MR;
+    for (size_t k = 0; k < K; ++k) {
+      size_t r = 0;
+      for (; r < rows; ++r) {
+        *packed++ = A[(i + r) * lda + k];
+      }
+      for (; r < SGEMM_MR; ++r) {
+        *packed++ = 0.0f;
+      }
+    }
+  }
+}
+
+void sgemm_pack_b(size_t K, size_t N, const float *B, size_t ldb, float *packed) {
+  for (size_t j = 0; j < N; j += SGEMM_NR) {
+    size_t cols = N - j < SGEMM_NR ? N - j : SGEMM_NR;
+    for (size_t k = 0; k < K; ++k) {
+      memcpy(packed, B + k * ldb + j, cols * sizeof(float));
+      memset(packed + cols, 0, (SGEMM_NR - cols) * sizeof(float));
+      packed += SGEMM_NR;
+    }
+  }
+}
+
+// micro-kernels: tile[r][c] = sum over k of a[k][r] * b[k][c] for one packed panel of each
+
+static void micro_kernel_scalar(size_t K, const float *a, const float *b, float tile[SGEMM_MR][SGEMM_NR]) {
+  memset(tile, 0, sizeof(float) * SGEMM_MR * SGEMM_NR);
+  for (size_t k = 0; k < K; ++k, a += SGEMM_MR, b += SGEMM_NR) {
+    for (int r = 0; r < SGEMM_MR; ++r) {
+      for (int c = 0; c < SGEMM_NR; ++c) {
+        tile[r][c] += a[r] * b[c];
+      }
+    }
+  }
+}
+
+#ifdef GEMM_HAS_FMA_KERNELS
+// 6 x 16 register tile: twelve ymm accumulators, two loads of B and six broadcasts of A per k, which leaves
+// the two FMA ports busy and needs nothing from memory but the two packed panels.
+__attribute__((target("avx2,fma"))) static void micro_kernel_fma(size_t K, const float *a, const float *b,
+                                                                 float tile[SGEMM_MR][SGEMM_NR]) {
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+  for (size_t k = 0; k < K; ++k, a += SGEMM_MR, b += SGEMM_NR) {
+    __m256 b0 = _mm256_loadu_ps(b);
+    __m256 b1 = _mm256_loadu_ps(b + 8);
+    __m256 v = _mm256_broadcast_ss(a);
+    c00 = _mm256_fmadd_ps(v, b0, c00);
+    c01 = _mm256_fmadd_ps(v, b1, c01);
+    v = _mm256_broadcast_ss(a + 1);
+    c10 = _mm256_fmadd_ps(v, b0, c10);
+    c11 = _mm256_fmadd_ps(v, b1, c11);
+    v = _mm256_broadcast_ss(a + 2);
+    c20 = _mm256_fmadd_ps(v, b0, c20);
+    c21 = _mm256_fmadd_ps(v, b1, c21);
+    v = _mm256_broadcast_ss(a + 3);
+    c30 = _mm256_fmadd_ps(v, b0, c30);
+    c31 = _mm256_fmadd_ps(v, b1, c31);
+    v = _mm256_broadcast_ss(a + 4);
+    c40 = _mm256_fmadd_ps(v, b0, c40);
+    c41 = _mm256_fmadd_ps(v, b1, c41);
+    v = _mm256_broadcast_ss(a + 5);
+    c50 = _mm256_fmadd_ps(v, b0, c50);
+    c51 = _mm256_fmadd_ps(v, b1, c51);
+  }
+  _mm256_storeu_ps(tile[0], c00);
+  _mm256_storeu_ps(tile[0] + 8, c01);
+  _mm256_storeu_ps(tile[1], c10);
+  _mm256_storeu_ps(tile[1] + 8, c11);
+  _mm256_storeu_ps(tile[2], c20);
+  _mm256_storeu_ps(tile[2] + 8, c21);
+  _mm256_storeu_ps(tile[3], c30);
+  _mm256_storeu_ps(tile[3] + 8, c31);
+  _mm256_storeu_ps(tile[4], c40);
+  _mm256_storeu_ps(tile[4] + 8, c41);
+  _mm256_storeu_ps(tile[5], c50);
+  _mm256_storeu_ps(tile[5] + 8, c51);
+}
+#endif
+
+// C += A * B over whole packed operands; partial tiles at the bottom and right edges add only their valid part.
+static void macro_kernel(size_t M, size_t N, size_t K, const float *packed_a, const float *packed_b, float *C,
+                         size_t ldc) {
+  void (*micro_kernel)(size_t, const float *, const float *, float[SGEMM_MR][SGEMM_NR]) = micro_kernel_scalar;
+#ifdef GEMM_HAS_FMA_KERNELS
+  if (has_fma()) {
+    micro_kernel = micro_kernel_fma;
+  }
+#endif
+  float tile[SGEMM_MR][SGEMM_NR];
+  for (size_t j = 0; j < N; j += SGEMM_NR) {
+    size_t cols = N - j < SGEMM_NR ? N - j : SGEMM_NR;
+    const float *b = packed_b + j * K;
+    for (size_t i = 0; i < M; i += SGEMM_MR) {
+      size_t rows = M - i < SGEMM_MR ? M - i : SGEMM_MR;
+      micro_kernel(K, packed_a + i * K, b, tile);
+      for (size_t r = 0; r < rows; ++r) {
+        float *c = C + (i + r) * ldc + j;
+        for (size_t col = 0; col < cols; ++col) {
+          c[col] += tile[r][col];
+        }
+      }
+    }
+  }
+}
+
+void sgemm_packed(size_t M, size_t N, size_t K, const float *packed_a, const float *packed_b, float *C, size_t ldc) {
+  if (K == 0) {
+    return;
+  }
+  macro_kernel(M, N, K, packed_a, packed_b, C, ldc);
+}
+
+static void sgemm_naive(size_t M, size_t N, size_t K, const float *A, size_t lda, const float *B, size_t ldb,
+                        float *C, size_t ldc) {
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t k = 0; k < K; ++k) {
+      for (size_t j = 0; j < N; ++j) {
+        C[i * ldc + j] += A[i * lda + k] * B[k * ldb + j];
+      }
+    }
+  }
+}
+
+// Falls back to the plain loop if the packing buffers cannot be allocated.
+void sgemm(size_t M, size_t N, size_t K, const float *A, size_t lda, const float *B, size_t ldb, float *C,
+           size_t ldc) {
+  if (M == 0 || N == 0 || K == 0) {
+    return;
+  }
+  size_t kc_max = K < KC ? K : KC;
+  size_t a_size = sgemm_packed_a_size(M < MC ? M : MC, kc_max);
+  size_t b_size = sgemm_packed_b_size(kc_max, N < NC ? N : NC);
+  float *packed_a = malloc(a_size * sizeof(float));
+  float *packed_b = malloc(b_size * sizeof(float));
+  if (!packed_a || !packed_b) {
+    free(packed_a);
+    free(packed_b);
+    sgemm_naive(M, N, K, A, lda, B, ldb, C, ldc);
+    return;
+  }
+  for (size_t jc = 0; jc < N; jc += NC) {
+    size_t nc = N - jc < NC ? N - jc : NC;
+    for (size_t pc = 0; pc < K; pc += KC) {
+      size_t kc = K - pc < KC ? K - pc : KC;
+      sgemm_pack_b(kc, nc, B + pc * ldb + jc, ldb, packed_b);
+      for (size_t ic = 0; ic < M; ic += MC) {
+        size_t mc = M - ic < MC ? M - ic : MC;
+        sgemm_pack_a(mc, kc, A + ic * lda + pc, lda, packed_a);
+        macro_kernel(mc, nc, kc, packed_a, packed_b, C + ic * ldc + jc, ldc);
+      }
+    }
+  }
+  free(packed_a);
+  free(packed_b);
+}
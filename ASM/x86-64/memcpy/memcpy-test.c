@@ -0,0 +1,156 @@
+// Checks the four functions of memcpy.s against libc. Each function first gets a call of its own above 64 bytes
+// in a fresh child process, so that it is the one that goes through resolve_; then all of them are compared
+// with libc over every size up to 600 bytes and a spread of larger ones, at many offsets and overlaps.
+//
+//   gcc -O2 memcpy-test.c memcpy.s -o memcpy-test && ./memcpy-test
+//
+// The counts are passed with garbage in the upper 32 bits, which the functions have to ignore.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void *my_memcpy(void *dest, const void *src, uint64_t count);
+void *my_memmove(void *dest, const void *src, uint64_t count);
+void *my_memset(void *dest, int ch, uint64_t count);
+int my_memcmp(const void *lhs, const void *rhs, uint64_t count);
+
+enum { BUFFER = 1 << 17, BASE = 20000 };
+
+static const uint64_t garbage = 0xdeadbeef00000000u;
+
+static unsigned char a[BUFFER], b[BUFFER], want[BUFFER];
+static long failures;
+
+static void fail(const char *what, int n, int detail) {
+  if (failures++ < 10) {
+    printf("%s: wrong result for %d bytes (%d)\n", what, n, detail);
+  }
+}
+
+static int sign(int x) {
+  return (x > 0) - (x < 0);
+}
+
+static void fill_random(unsigned char *p, int n) {
+  for (int i = 0; i < n; ++i) {
+    p[i] = (unsigned char)rand();
+  }
+}
+
+// First calls, one per process. Each returns 0 when the call gives the right result.
+
+static int first_memcpy(void) {
+  fill_random(a, 1000);
+  return my_memcpy(b, a, garbage | 1000) != b || memcmp(a, b, 1000) != 0;
+}
+
+static int first_memmove(void) {
+  fill_random(a, 1008);
+  memcpy(want, a, 1008);
+  memmove(want + 8, want, 1000);
+  return my_memmove(a + 8, a, garbage | 1000) != a + 8 || memcmp(a, want, 1008) != 0;
+}
+
+static int first_memset(void) {
+  memset(want, 0x5a, 1000);
+  return my_memset(a, 0x35a, garbage | 1000) != a || memcmp(a, want, 1000) != 0;
+}
+
+// The difference lies past the first block, so the loop has to carry its offset across the resolve_ call.
+static int first_memcmp(void) {
+  fill_random(a, 1000);
+  memcpy(b, a, 1000);
+  b[700] = (unsigned char)(a[700] ^ 0x80);
+  return my_memcmp(a, b, garbage | 1000) != a[700] - b[700];
+}
+
+static void run_first_call(const char *name, int (*first_call)(void)) {
+  fflush(stdout);
+  pid_t child = fork();
+  if (child == 0) {
+    _exit(first_call());
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+  if (WIFSIGNALED(status)) {
+    printf("first call of %s: killed by signal %d\n", name, WTERMSIG(status));
+    ++failures;
+  } else if (WEXITSTATUS(status) != 0) {
+    printf("first call of %s: wrong result\n", name);
+    ++failures;
+  }
+}
+
+// my_memcpy and my_memmove between disjoint and overlapping ranges, distance d apart.
+static void check_copy(int n) {
+  for (int d = -140; d <= 140; d += n > 600 ? 37 : 1) {
+    fill_random(a + BASE - 200, n + 600);
+    memcpy(want, a, BUFFER);
+    int src = BASE + 3;
+    int dst = src + d;
+    memmove(want + dst, want + src, (size_t)n);
+    if (my_memmove(a + dst, a + src, garbage | (uint64_t)n) != a + dst || memcmp(a, want, BUFFER) != 0) {
+      fail("my_memmove", n, d);
+    }
+    if (d <= -n || d >= n) {
+      fill_random(a + BASE - 200, n + 600);
+      memcpy(want, a, BUFFER);
+      memcpy(want + dst, want + src, (size_t)n);
+      if (my_memcpy(a + dst, a + src, garbage | (uint64_t)n) != a + dst || memcmp(a, want, BUFFER) != 0) {
+        fail("my_memcpy", n, d);
+      }
+    }
+  }
+}
+
+static void check_set_and_compare(int n) {
+  for (int offset = 0; offset < 33; offset += n > 600 ? 11 : 1) {
+    memset(a, 7, (size_t)(2 * n + 200));
+    memcpy(want, a, (size_t)(2 * n + 200));
+    memset(want + offset, 0xa5, (size_t)n);
+    if (my_memset(a + offset, 0x3a5, garbage | (uint64_t)n) != a + offset ||
+        memcmp(a, want, (size_t)(2 * n + 200)) != 0) {
+      fail("my_memset", n, offset);
+    }
+
+    fill_random(a, n + 40);
+    fill_random(b, n + 40);
+    if (sign(my_memcmp(a + offset, b + offset, garbage | (uint64_t)n)) != sign(memcmp(a + offset, b + offset, n))) {
+      fail("my_memcmp on random bytes", n, offset);
+    }
+    memcpy(b + offset, a + offset, (size_t)n);
+    if (my_memcmp(a + offset, b + offset, garbage | (uint64_t)n) != 0) {
+      fail("my_memcmp on equal bytes", n, offset);
+    }
+    if (n > 0) {
+      int k = rand() % n;
+      b[offset + k] ^= 0x80;
+      int difference = a[offset + k] - b[offset + k];
+      if (my_memcmp(a + offset, b + offset, garbage | (uint64_t)n) != difference) {
+        fail("my_memcmp on one difference", n, k);
+      }
+      b[offset + n - 1] ^= 1;  // a later difference must not win
+      if (k < n - 1 && my_memcmp(a + offset, b + offset, (uint64_t)n) != difference) {
+        fail("my_memcmp on two differences", n, k);
+      }
+    }
+  }
+}
+
+int main(void) {
+  run_first_call("my_memcpy", first_memcpy);
+  run_first_call("my_memmove", first_memmove);
+  run_first_call("my_memset", first_memset);
+  run_first_call("my_memcmp", first_memcmp);
+
+  for (int n = 0; n < 40000; n = n < 600 ? n + 1 : n * 5 / 4 + 7) {
+    check_copy(n);
+    check_set_and_compare(n);
+  }
+  printf("%s\n", failures == 0 ? "all checks passed" : "FAILED");
+  return failures != 0;
+}
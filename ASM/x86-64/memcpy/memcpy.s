@@ -1,46 +1,938 @@
   .intel_syntax noprefix
 
+# void* my_memcpy(void* dest, const void* src, uint32_t count)
+# void* my_memmove(void* dest, const void* src, uint32_t count)
+# void* my_memset(void* dest, int ch, uint32_t count)
+# int my_memcmp(const void* lhs, const void* rhs, uint32_t count)
+#
+# Up to 64 bytes are handled inline with a pair of accesses at each end of the buffer that overlap in the
+# middle, so every size in a tier takes the same straight-line code. Larger sizes jump through a pointer per
+# function, which starts out at a stub calling resolve_: the first call reads CPUID, picks the AVX(2) or SSE2
+# loops and the thresholds for rep movsb (ERMS/FSRM), rep stosb (ERMS) and non-temporal stores (size of the
+# last-level cache), and stores the choice for all four functions. No libc and no loader support is needed
+# for that, unlike an ifunc.
+
+  .data
+  .balign 8
+copy_large_:
+  .quad copy_resolve_
+move_large_:
+  .quad move_resolve_
+set_large_:
+  .quad set_resolve_
+cmp_large_:
+  .quad cmp_resolve_
+rep_movsb_threshold_:
+  .quad -1
+rep_stosb_threshold_:
+  .quad -1
+non_temporal_threshold_:
+  .quad -1
+
   .text
   .global my_memcpy
 
 my_memcpy:
 
-  push rbp
-  mov rbp, rsp
+  mov rax, rdi
+  mov edx, edx
 
-  push rdi
+# Copies up to 64 bytes with all loads done before the first store, which makes it safe for memmove too.
+copy_small_:
+
+  cmp rdx, 16
+  ja above_16_
+  cmp edx, 8
+  jb below_8_
+  mov rcx, [rsi]
+  mov r8, [rsi + rdx - 8]
+  mov [rdi], rcx
+  mov [rdi + rdx - 8], r8
+  ret
+
+below_8_:
+
+  cmp edx, 4
+  jb below_4_
+  mov ecx, [rsi]
+  mov r8d, [rsi + rdx - 4]
+  mov [rdi], ecx
+  mov [rdi + rdx - 4], r8d
+  ret
+
+below_4_:
 
   test edx, edx
   jz end_
+  movzx ecx, byte ptr [rsi]
+  cmp edx, 2
+  jb one_byte_
+  movzx r8d, word ptr [rsi + rdx - 2]
+  mov [rdi + rdx - 2], r8w
+
+one_byte_:
+
+  mov [rdi], cl
+
+end_:
+  ret
+
+above_16_:
+
+  cmp rdx, 32
+  ja above_32_
+  movdqu xmm0, [rsi]
+  movdqu xmm1, [rsi + rdx - 16]
+  movdqu [rdi], xmm0
+  movdqu [rdi + rdx - 16], xmm1
+  ret
+
+above_32_:
+
+  cmp rdx, 64
+  ja above_64_
+  movdqu xmm0, [rsi]
+  movdqu xmm1, [rsi + 16]
+  movdqu xmm2, [rsi + rdx - 32]
+  movdqu xmm3, [rsi + rdx - 16]
+  movdqu [rdi], xmm0
+  movdqu [rdi + 16], xmm1
+  movdqu [rdi + rdx - 32], xmm2
+  movdqu [rdi + rdx - 16], xmm3
+  ret
+
+above_64_:
+
+  jmp [rip + copy_large_]
+
+# count > 64 in rdx, rax = dest. The last 128 bytes are loaded up front and stored after the loop, which
+# starts at the first 32-byte aligned destination address and may overlap both ends.
+
+copy_avx_:
+
+  cmp rdx, 128
+  ja avx_above_128_
+  vmovdqu ymm0, [rsi]
+  vmovdqu ymm1, [rsi + 32]
+  vmovdqu ymm2, [rsi + rdx - 64]
+  vmovdqu ymm3, [rsi + rdx - 32]
+  vmovdqu [rdi], ymm0
+  vmovdqu [rdi + 32], ymm1
+  vmovdqu [rdi + rdx - 64], ymm2
+  vmovdqu [rdi + rdx - 32], ymm3
+  vzeroupper
+  ret
+
+avx_above_128_:
+
+  cmp rdx, [rip + non_temporal_threshold_]
+  jae avx_non_temporal_
+  cmp rdx, [rip + rep_movsb_threshold_]
+  jae copy_rep_movsb_
+  vmovdqu ymm4, [rsi + rdx - 128]
+  vmovdqu ymm5, [rsi + rdx - 96]
+  vmovdqu ymm6, [rsi + rdx - 64]
+  vmovdqu ymm7, [rsi + rdx - 32]
+  vmovdqu ymm0, [rsi]
+  vmovdqu [rdi], ymm0
+  lea r8, [rdi + rdx - 128]
+  mov r9, rdi
+  neg r9
+  and r9, 31
+  lea rcx, [rdi + r9]
+  lea r10, [rsi + r9]
+  cmp rcx, r8
+  jae avx_tail_
+
+avx_loop_:
+
+  vmovdqu ymm0, [r10]
+  vmovdqu ymm1, [r10 + 32]
+  vmovdqu ymm2, [r10 + 64]
+  vmovdqu ymm3, [r10 + 96]
+  vmovdqa [rcx], ymm0
+  vmovdqa [rcx + 32], ymm1
+  vmovdqa [rcx + 64], ymm2
+  vmovdqa [rcx + 96], ymm3
+  add rcx, 128
+  add r10, 128
+  cmp rcx, r8
+  jb avx_loop_
+
+avx_tail_:
+
+  vmovdqu [r8], ymm4
+  vmovdqu [r8 + 32], ymm5
+  vmovdqu [r8 + 64], ymm6
+  vmovdqu [r8 + 96], ymm7
+  vzeroupper
+  ret
+
+# Copies bigger than the last-level cache would only evict it, so they bypass it with streaming stores.
+
+avx_non_temporal_:
+
+  vmovdqu ymm4, [rsi + rdx - 128]
+  vmovdqu ymm5, [rsi + rdx - 96]
+  vmovdqu ymm6, [rsi + rdx - 64]
+  vmovdqu ymm7, [rsi + rdx - 32]
+  vmovdqu ymm0, [rsi]
+  vmovdqu [rdi], ymm0
+  lea r8, [rdi + rdx - 128]
+  mov r9, rdi
+  neg r9
+  and r9, 31
+  lea rcx, [rdi + r9]
+  lea r10, [rsi + r9]
+
+avx_non_temporal_loop_:
+
+  prefetcht0 [r10 + 512]
+  vmovdqu ymm0, [r10]
+  vmovdqu ymm1, [r10 + 32]
+  vmovdqu ymm2, [r10 + 64]
+  vmovdqu ymm3, [r10 + 96]
+  vmovntdq [rcx], ymm0
+  vmovntdq [rcx + 32], ymm1
+  vmovntdq [rcx + 64], ymm2
+  vmovntdq [rcx + 96], ymm3
+  add rcx, 128
+  add r10, 128
+  cmp rcx, r8
+  jb avx_non_temporal_loop_
+  sfence
+  jmp avx_tail_
+
+copy_rep_movsb_:
+
+  mov rcx, rdx
+  rep movsb
+  ret
+
+# Same scheme with 16-byte registers for CPUs or kernels without AVX.
+
+copy_sse2_:
+
+  cmp rdx, [rip + rep_movsb_threshold_]
+  jae copy_rep_movsb_
+  movdqu xmm4, [rsi + rdx - 64]
+  movdqu xmm5, [rsi + rdx - 48]
+  movdqu xmm6, [rsi + rdx - 32]
+  movdqu xmm7, [rsi + rdx - 16]
+  movdqu xmm0, [rsi]
+  movdqu [rdi], xmm0
+  lea r8, [rdi + rdx - 64]
+  mov r9, rdi
+  neg r9
+  and r9, 15
+  lea rcx, [rdi + r9]
+  lea r10, [rsi + r9]
+  cmp rcx, r8
+  jae sse2_tail_
+
+sse2_loop_:
+
+  movdqu xmm0, [r10]
+  movdqu xmm1, [r10 + 16]
+  movdqu xmm2, [r10 + 32]
+  movdqu xmm3, [r10 + 48]
+  movdqa [rcx], xmm0
+  movdqa [rcx + 16], xmm1
+  movdqa [rcx + 32], xmm2
+  movdqa [rcx + 48], xmm3
+  add rcx, 64
+  add r10, 64
+  cmp rcx, r8
+  jb sse2_loop_
+
+sse2_tail_:
 
-loop_:
+  movdqu [r8], xmm4
+  movdqu [r8 + 16], xmm5
+  movdqu [r8 + 32], xmm6
+  movdqu [r8 + 48], xmm7
+  ret
+
+# my_memmove: the small tiers are shared with my_memcpy. Above 64 bytes, disjoint buffers take the memcpy loop,
+# a destination below the source is copied front to back and one above it back to front. Both directions
+# load the first and the last block before any store and run the loop on aligned destination addresses in
+# between, so each load happens before the store that could overwrite its bytes. Up to 128 bytes copy_avx_
+# loads everything before its first store, so it serves overlapping buffers too.
+
+  .global my_memmove
+
+my_memmove:
+
+  mov rax, rdi
+  mov edx, edx
+  cmp rdx, 64
+  jbe copy_small_
+  jmp [rip + move_large_]
+
+move_avx_:
+
+  cmp rdx, 128
+  jbe copy_avx_
+  mov rcx, rdi
+  sub rcx, rsi
+  jz move_done_
+  cmp rcx, rdx
+  jb move_avx_backward_
+  mov rcx, rsi
+  sub rcx, rdi
+  cmp rcx, rdx
+  jae copy_avx_
+  vmovdqu ymm4, [rsi + rdx - 128]
+  vmovdqu ymm5, [rsi + rdx - 96]
+  vmovdqu ymm6, [rsi + rdx - 64]
+  vmovdqu ymm7, [rsi + rdx - 32]
+  vmovdqu ymm8, [rsi]
+  lea r8, [rdi + rdx - 128]
+  mov r9, rdi
+  neg r9
+  and r9, 31
+  lea rcx, [rdi + r9]
+  lea r10, [rsi + r9]
+  cmp rcx, r8
+  jae move_avx_forward_tail_
+
+move_avx_forward_loop_:
+
+  vmovdqu ymm0, [r10]
+  vmovdqu ymm1, [r10 + 32]
+  vmovdqu ymm2, [r10 + 64]
+  vmovdqu ymm3, [r10 + 96]
+  vmovdqa [rcx], ymm0
+  vmovdqa [rcx + 32], ymm1
+  vmovdqa [rcx + 64], ymm2
+  vmovdqa [rcx + 96], ymm3
+  add rcx, 128
+  add r10, 128
+  cmp rcx, r8
+  jb move_avx_forward_loop_
+
+move_avx_forward_tail_:
+
+  vmovdqu [rdi], ymm8
+  jmp avx_tail_
+
+move_avx_backward_:
+
+  vmovdqu ymm4, [rsi]
+  vmovdqu ymm5, [rsi + 32]
+  vmovdqu ymm6, [rsi + 64]
+  vmovdqu ymm7, [rsi + 96]
+  vmovdqu ymm8, [rsi + rdx - 32]
+  lea rcx, [rdi + rdx]
+  and rcx, -32
+  mov r10, rcx
+  sub r10, rdi
+  add r10, rsi
+  lea r8, [rdi + 128]
+  cmp rcx, r8
+  jbe move_avx_head_
+
+move_avx_backward_loop_:
+
+  sub rcx, 128
+  sub r10, 128
+  vmovdqu ymm0, [r10]
+  vmovdqu ymm1, [r10 + 32]
+  vmovdqu ymm2, [r10 + 64]
+  vmovdqu ymm3, [r10 + 96]
+  vmovdqa [rcx], ymm0
+  vmovdqa [rcx + 32], ymm1
+  vmovdqa [rcx + 64], ymm2
+  vmovdqa [rcx + 96], ymm3
+  cmp rcx, r8
+  ja move_avx_backward_loop_
+
+move_avx_head_:
+
+  vmovdqu [rdi + rdx - 32], ymm8
+  vmovdqu [rdi], ymm4
+  vmovdqu [rdi + 32], ymm5
+  vmovdqu [rdi + 64], ymm6
+  vmovdqu [rdi + 96], ymm7
+  vzeroupper
+
+move_done_:
+  ret
+
+move_sse2_:
+
+  mov rcx, rdi
+  sub rcx, rsi
+  jz move_done_
+  cmp rcx, rdx
+  jb move_sse2_backward_
+  mov rcx, rsi
+  sub rcx, rdi
+  cmp rcx, rdx
+  jae copy_sse2_
+  movdqu xmm4, [rsi + rdx - 64]
+  movdqu xmm5, [rsi + rdx - 48]
+  movdqu xmm6, [rsi + rdx - 32]
+  movdqu xmm7, [rsi + rdx - 16]
+  movdqu xmm8, [rsi]
+  lea r8, [rdi + rdx - 64]
+  mov r9, rdi
+  neg r9
+  and r9, 15
+  lea rcx, [rdi + r9]
+  lea r10, [rsi + r9]
+  cmp rcx, r8
+  jae move_sse2_forward_tail_
+
+move_sse2_forward_loop_:
+
+  movdqu xmm0, [r10]
+  movdqu xmm1, [r10 + 16]
+  movdqu xmm2, [r10 + 32]
+  movdqu xmm3, [r10 + 48]
+  movdqa [rcx], xmm0
+  movdqa [rcx + 16], xmm1
+  movdqa [rcx + 32], xmm2
+  movdqa [rcx + 48], xmm3
+  add rcx, 64
+  add r10, 64
+  cmp rcx, r8
+  jb move_sse2_forward_loop_
+
+move_sse2_forward_tail_:
 
+  movdqu [rdi], xmm8
+  jmp sse2_tail_
+
+move_sse2_backward_:
+
+  movdqu xmm4, [rsi]
+  movdqu xmm5, [rsi + 16]
+  movdqu xmm6, [rsi + 32]
+  movdqu xmm7, [rsi + 48]
+  movdqu xmm8, [rsi + rdx - 16]
+  lea rcx, [rdi + rdx]
+  and rcx, -16
+  mov r10, rcx
+  sub r10, rdi
+  add r10, rsi
+  lea r8, [rdi + 64]
+  cmp rcx, r8
+  jbe move_sse2_head_
+
+move_sse2_backward_loop_:
+
+  sub rcx, 64
+  sub r10, 64
+  movdqu xmm0, [r10]
+  movdqu xmm1, [r10 + 16]
+  movdqu xmm2, [r10 + 32]
+  movdqu xmm3, [r10 + 48]
+  movdqa [rcx], xmm0
+  movdqa [rcx + 16], xmm1
+  movdqa [rcx + 32], xmm2
+  movdqa [rcx + 48], xmm3
+  cmp rcx, r8
+  ja move_sse2_backward_loop_
+
+move_sse2_head_:
+
+  movdqu [rdi + rdx - 16], xmm8
+  movdqu [rdi], xmm4
+  movdqu [rdi + 16], xmm5
+  movdqu [rdi + 32], xmm6
+  movdqu [rdi + 48], xmm7
+  ret
+
+# my_memset: the byte is spread over rcx (and xmm0 above 16 bytes) and stored with the same tiers as memcpy.
+
+  .global my_memset
+
+my_memset:
+
+  mov rax, rdi
+  mov edx, edx
+  movzx ecx, sil
+  mov r8, 0x0101010101010101
+  imul rcx, r8
+  cmp rdx, 16
+  ja set_above_16_
   cmp edx, 8
-  jl rem_
+  jb set_below_8_
+  mov [rdi], rcx
+  mov [rdi + rdx - 8], rcx
+  ret
 
-  mov rax, [rsi]
-  mov [rdi], rax
-  add rdi, 8
-  add rsi, 8
-  sub edx, 8
+set_below_8_:
 
-  jmp loop_
+  cmp edx, 4
+  jb set_below_4_
+  mov [rdi], ecx
+  mov [rdi + rdx - 4], ecx
+  ret
 
-rem_:
+set_below_4_:
 
   test edx, edx
-  jz end_
+  jz set_done_
+  mov [rdi], cl
+  cmp edx, 2
+  jb set_done_
+  mov [rdi + rdx - 2], cx
+
+set_done_:
+  ret
 
-  mov al, [rsi]
-  mov [rdi], al
-  inc rsi
-  inc rdi
-  sub edx, 1
-  jmp rem_
+set_above_16_:
 
+  movq xmm0, rcx
+  punpcklqdq xmm0, xmm0
+  cmp rdx, 32
+  ja set_above_32_
+  movdqu [rdi], xmm0
+  movdqu [rdi + rdx - 16], xmm0
+  ret
 
-end_:
+set_above_32_:
+
+  cmp rdx, 64
+  ja set_above_64_
+  movdqu [rdi], xmm0
+  movdqu [rdi + 16], xmm0
+  movdqu [rdi + rdx - 32], xmm0
+  movdqu [rdi + rdx - 16], xmm0
+  ret
+
+set_above_64_:
+
+  jmp [rip + set_large_]
+
+# count > 64 in rdx, pattern in xmm0, rax = dest. Head and last 128 bytes are stored unaligned, the loop in
+# between from the first 32-byte aligned address.
+
+set_avx_:
+
+  cmp rdx, [rip + non_temporal_threshold_]
+  jae set_avx_wide_
+  cmp rdx, [rip + rep_stosb_threshold_]
+  jae set_rep_stosb_
+
+set_avx_wide_:
+
+  vinsertf128 ymm0, ymm0, xmm0, 1
+  cmp rdx, 128
+  ja set_avx_above_128_
+  vmovdqu [rdi], ymm0
+  vmovdqu [rdi + 32], ymm0
+  vmovdqu [rdi + rdx - 64], ymm0
+  vmovdqu [rdi + rdx - 32], ymm0
+  vzeroupper
+  ret
+
+set_avx_above_128_:
+
+  lea r8, [rdi + rdx - 128]
+  vmovdqu [rdi], ymm0
+  lea rcx, [rdi + 32]
+  and rcx, -32
+  cmp rdx, [rip + non_temporal_threshold_]
+  jae set_avx_non_temporal_loop_
+  cmp rcx, r8
+  jae set_avx_tail_
+
+set_avx_loop_:
+
+  vmovdqa [rcx], ymm0
+  vmovdqa [rcx + 32], ymm0
+  vmovdqa [rcx + 64], ymm0
+  vmovdqa [rcx + 96], ymm0
+  add rcx, 128
+  cmp rcx, r8
+  jb set_avx_loop_
+
+set_avx_tail_:
+
+  vmovdqu [r8], ymm0
+  vmovdqu [r8 + 32], ymm0
+  vmovdqu [r8 + 64], ymm0
+  vmovdqu [r8 + 96], ymm0
+  vzeroupper
+  ret
+
+set_avx_non_temporal_loop_:
+
+  vmovntdq [rcx], ymm0
+  vmovntdq [rcx + 32], ymm0
+  vmovntdq [rcx + 64], ymm0
+  vmovntdq [rcx + 96], ymm0
+  add rcx, 128
+  cmp rcx, r8
+  jb set_avx_non_temporal_loop_
+  sfence
+  jmp set_avx_tail_
+
+set_rep_stosb_:
+
+  mov r9, rax
+  mov rcx, rdx
+  movzx eax, sil
+  rep stosb
+  mov rax, r9
+  ret
+
+set_sse2_:
+
+  cmp rdx, [rip + rep_stosb_threshold_]
+  jae set_rep_stosb_
+  lea r8, [rdi + rdx - 64]
+  movdqu [rdi], xmm0
+  lea rcx, [rdi + 16]
+  and rcx, -16
+  cmp rcx, r8
+  jae set_sse2_tail_
+
+set_sse2_loop_:
+
+  movdqa [rcx], xmm0
+  movdqa [rcx + 16], xmm0
+  movdqa [rcx + 32], xmm0
+  movdqa [rcx + 48], xmm0
+  add rcx, 64
+  cmp rcx, r8
+  jb set_sse2_loop_
+
+set_sse2_tail_:
+
+  movdqu [r8], xmm0
+  movdqu [r8 + 16], xmm0
+  movdqu [r8 + 32], xmm0
+  movdqu [r8 + 48], xmm0
+  ret
+
+# my_memcmp returns the difference of the first pair of unequal bytes, compared as unsigned char, or 0. Blocks
+# at both ends may overlap: everything before the second one is already known to be equal.
+
+  .global my_memcmp
+
+my_memcmp:
+
+  mov edx, edx
+  xor r8d, r8d
+  cmp rdx, 16
+  ja cmp_above_16_
+  cmp edx, 8
+  jb cmp_below_8_
+  mov rax, [rdi]
+  xor rax, [rsi]
+  jnz cmp_diff_bits_
+  lea r8, [rdx - 8]
+  mov rax, [rdi + r8]
+  xor rax, [rsi + r8]
+  jnz cmp_diff_bits_
+  ret
+
+cmp_below_8_:
+
+  cmp edx, 4
+  jb cmp_below_4_
+  mov eax, [rdi]
+  xor eax, [rsi]
+  jnz cmp_diff_bits_
+  lea r8, [rdx - 4]
+  mov eax, [rdi + r8]
+  xor eax, [rsi + r8]
+  jnz cmp_diff_bits_
+  ret
+
+cmp_below_4_:
+
+  xor eax, eax
+  test edx, edx
+  jz cmp_done_
+
+cmp_bytes_loop_:
+
+  movzx eax, byte ptr [rdi + r8]
+  movzx ecx, byte ptr [rsi + r8]
+  sub eax, ecx
+  jnz cmp_done_
+  inc r8
+  cmp r8, rdx
+  jb cmp_bytes_loop_
+
+cmp_done_:
+  ret
+
+# rax = xor of the little-endian words at offset r8, non-zero: its lowest set bit is in the first unequal byte.
+cmp_diff_bits_:
+
+  bsf rax, rax
+  shr eax, 3
+  add r8, rax
+
+# r8 = offset of the first unequal byte.
+cmp_diff_at_:
+
+  movzx eax, byte ptr [rdi + r8]
+  movzx ecx, byte ptr [rsi + r8]
+  sub eax, ecx
+  ret
+
+# Compares the 16 bytes at r8 + disp; on a mismatch r8 is moved to them.
+  .macro cmp16 disp=0
+  movdqu xmm0, [rdi + r8 + \disp]
+  movdqu xmm1, [rsi + r8 + \disp]
+  pcmpeqb xmm0, xmm1
+  pmovmskb eax, xmm0
+  xor eax, 0xFFFF
+  jz 1f
+  add r8, \disp
+  jmp cmp_diff_mask_
+1:
+  .endm
+
+cmp_above_16_:
+
+  cmp rdx, 32
+  ja cmp_above_32_
+  cmp16
+  lea r8, [rdx - 16]
+  cmp16
+  ret
+
+cmp_above_32_:
+
+  cmp rdx, 64
+  ja cmp_above_64_
+  cmp16
+  cmp16 16
+  lea r8, [rdx - 32]
+  cmp16
+  cmp16 16
+  ret
+
+cmp_above_64_:
+
+  jmp [rip + cmp_large_]
+
+# eax = mask of the unequal bytes of the 16 at offset r8, non-zero.
+cmp_diff_mask_:
+
+  bsf eax, eax
+  add r8, rax
+  jmp cmp_diff_at_
+
+# count > 64 in rdx, r8 = 0. 64-byte blocks, the last one ending at count.
+
+  .macro cmp64_avx2
+  vmovdqu ymm0, [rdi + r8]
+  vmovdqu ymm1, [rdi + r8 + 32]
+  vpcmpeqb ymm0, ymm0, [rsi + r8]
+  vpcmpeqb ymm1, ymm1, [rsi + r8 + 32]
+  vpand ymm2, ymm0, ymm1
+  vpmovmskb eax, ymm2
+  cmp eax, -1
+  jne cmp_avx2_found_
+  .endm
+
+cmp_avx2_:
+
+  lea r9, [rdx - 64]
+
+cmp_avx2_loop_:
+
+  cmp64_avx2
+  add r8, 64
+  cmp r8, r9
+  jb cmp_avx2_loop_
+  mov r8, r9
+  cmp64_avx2
+  xor eax, eax
+  vzeroupper
+  ret
+
+cmp_avx2_found_:
+
+  vpmovmskb eax, ymm0
+  not eax
+  test eax, eax
+  jnz cmp_avx2_found_at_
+  vpmovmskb eax, ymm1
+  not eax
+  add r8, 32
+
+cmp_avx2_found_at_:
+
+  vzeroupper
+  jmp cmp_diff_mask_
+
+cmp_sse2_:
+
+  lea r9, [rdx - 64]
+
+cmp_sse2_loop_:
+
+  cmp16
+  cmp16 16
+  cmp16 32
+  cmp16 48
+  add r8, 64
+  cmp r8, r9
+  jb cmp_sse2_loop_
+  mov r8, r9
+  cmp16
+  cmp16 16
+  cmp16 32
+  cmp16 48
+  xor eax, eax
+  ret
+
+# Runs on the first call above 64 bytes of any of the functions and leaves all registers but rflags as they
+# were, since the callers keep state in scratch registers too (my_memcmp its block offset in r8). Concurrent
+# first calls all compute and store the same values.
+
+copy_resolve_:
+
+  call resolve_
+  jmp [rip + copy_large_]
+
+move_resolve_:
+
+  call resolve_
+  jmp [rip + move_large_]
+
+set_resolve_:
+
+  call resolve_
+  jmp [rip + set_large_]
+
+cmp_resolve_:
+
+  call resolve_
+  jmp [rip + cmp_large_]
+
+resolve_:
+
+  push rbx
+  push rax
+  push rcx
+  push rdx
+  push rsi
+  push rdi
+  push r8
+  push r9
+  push r10
+  push r11
+  xor r11d, r11d                      # 1 with AVX, 2 with AVX2
+  xor r9d, r9d                        # last-level cache size
+  xor eax, eax
+  cpuid
+  mov esi, eax                        # highest leaf
+  mov eax, 1
+  cpuid
+  and ecx, 0x18000000                 # OSXSAVE, AVX
+  cmp ecx, 0x18000000
+  jne resolve_leaf7_
+  xor ecx, ecx
+  xgetbv
+  and eax, 0x6                        # XMM and YMM state
+  cmp eax, 0x6
+  jne resolve_leaf7_
+  mov r11d, 1
+
+resolve_leaf7_:
+
+  cmp esi, 7
+  jb resolve_cache_
+  mov eax, 7
+  xor ecx, ecx
+  cpuid
+  test r11d, r11d
+  jz resolve_erms_
+  test ebx, 0x20                      # AVX2
+  jz resolve_erms_
+  mov r11d, 2
+
+resolve_erms_:
+
+  test ebx, 0x200                     # ERMS
+  jz resolve_cache_
+  mov r8d, 2048
+  mov r10d, 1024
+  test edx, 0x10                      # FSRM: rep movsb is fast from smaller sizes on
+  cmovnz r8d, r10d
+  mov [rip + rep_movsb_threshold_], r8
+  mov qword ptr [rip + rep_stosb_threshold_], 2048
+
+resolve_cache_:
+
+  cmp esi, 4
+  jb resolve_select_
+  xor edi, edi
+
+resolve_cache_loop_:
+
+  mov eax, 4
+  mov ecx, edi
+  cpuid
+  test eax, 0x1F                      # no more caches
+  jz resolve_select_
+  mov r8d, ebx                        # ways * partitions * line size * sets
+  shr r8d, 22
+  inc r8d
+  mov r10d, ebx
+  shr r10d, 12
+  and r10d, 0x3FF
+  inc r10d
+  imul r8, r10
+  mov r10d, ebx
+  and r10d, 0xFFF
+  inc r10d
+  imul r8, r10
+  mov r10d, ecx
+  inc r10
+  imul r8, r10
+  cmp r8, r9
+  cmova r9, r8
+  inc edi
+  cmp edi, 16
+  jb resolve_cache_loop_
+
+resolve_select_:
+
+  mov r8d, 0x800000                   # 8 MiB when CPUID does not say
+  test r9, r9
+  cmovz r9, r8
+  mov [rip + non_temporal_threshold_], r9
+  lea r8, [rip + copy_sse2_]
+  lea r9, [rip + move_sse2_]
+  lea r10, [rip + set_sse2_]
+  lea rax, [rip + cmp_sse2_]
+  cmp r11d, 1
+  jb resolve_store_
+  lea r8, [rip + copy_avx_]
+  lea r9, [rip + move_avx_]
+  lea r10, [rip + set_avx_]
+  cmp r11d, 2
+  jb resolve_store_
+  lea rax, [rip + cmp_avx2_]
+
+resolve_store_:
+
+  mov [rip + copy_large_], r8
+  mov [rip + move_large_], r9
+  mov [rip + set_large_], r10
+  mov [rip + cmp_large_], rax
+  pop r11
+  pop r10
+  pop r9
+  pop r8
+  pop rdi
+  pop rsi
+  pop rdx
+  pop rcx
   pop rax
-  mov rsp, rbp
-  pop rbp
+  pop rbx
   ret
+
+  .section .note.GNU-stack, "", @progbits
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "arraytraits.hpp"
+
+// Layouts of an ArrayView. Each one maps the multi-index onto [0, Size()) one-to-one, so the elements are always
+// dense and can be walked as a flat range whatever the layout.
+
+// The last index is contiguous, as in a built-in array.
+struct RowMajor {};
+
+// The first index is contiguous.
+struct ColumnMajor {};
+
+// The last two dimensions are cut into kTileRows x kTileCols blocks, each stored row-major and contiguous, the
+// blocks themselves and the leading dimensions following in row-major order.
+template <size_t kTileRows, size_t kTileCols>
+struct Tiled {};
+
+namespace detail {
+template <class Layout>
+struct IsTiled : std::false_type {};
+
+template <size_t kTileRows, size_t kTileCols>
+struct IsTiled<Tiled<kTileRows, kTileCols>> : std::true_type {};
+
+template <class T>
+constexpr auto* FirstElement(T& array) {
+  if constexpr (kIsArrayV<T>) {
+    return FirstElement(array[0]);
+  } else {
+    return &array;
+  }
+}
+
+// Calls f(std::integral_constant<size_t, I>{}) for I in [0, kCount), unrolled at compile time.
+template <size_t kCount, class F>
+constexpr void Unrolled(F&& f) {
+  [&f]<size_t... kIs>(std::index_sequence<kIs...>) {
+    (f(std::integral_constant<size_t, kIs>{}), ...);
+  }(std::make_index_sequence<kCount>{});
+}
+}  // namespace detail
+
+// Non-owning multi-dimensional view described by an array type: ArrayView<float[4][8]> sees 32 floats as 4 x 8,
+// ArrayView<float[][8]> leaves the leading extent to the constructor, the only bound a C++ array type can omit.
+// Extents and strides come from kExtentV, so with static extents every offset folds into a constant expression
+// and Size() is the compile-time kTotalSizeV. Viewing a built-in array walks it as one flat buffer, which constant
+// evaluation rejects past its first row; constexpr code should view a flat buffer instead.
+template <class T, class Layout = RowMajor>
+class ArrayView {
+ public:
+  using ElementType = RemoveAllArraysT<T>;
+  static constexpr size_t kRank = kRankV<T>;
+  static constexpr bool kIsStatic = kExtentV<T, 0> != 0;
+
+ private:
+  static_assert(kIsArrayV<T>, "ArrayView is described by an array type");
+
+  static constexpr auto kExtents = []<size_t... kDims>(std::index_sequence<kDims...>) {
+    return std::array<size_t, kRank>{kExtentV<T, kDims>...};
+  }(std::make_index_sequence<kRank>{});
+
+  ElementType* data_;
+  size_t leading_;
+
+ public:
+  constexpr ArrayView(T& array) noexcept requires(kIsStatic);  // NOLINT
+  constexpr explicit ArrayView(ElementType* data) requires(kIsStatic);
+  constexpr ArrayView(ElementType* data, size_t leading) requires(!kIsStatic);
+
+  constexpr size_t Extent(size_t dim) const noexcept;
+  constexpr size_t Stride(size_t dim) const noexcept requires(!detail::IsTiled<Layout>::value);
+  constexpr size_t Size() const noexcept;
+  constexpr ElementType* Data() const noexcept;
+
+  template <class... Indices>
+  constexpr ElementType& operator()(Indices... indices) const noexcept requires(sizeof...(Indices) == kRank);
+
+  constexpr std::span<ElementType, kIsStatic ? kTotalSizeV<T> : std::dynamic_extent> Flat() const noexcept;
+  constexpr ElementType* begin() const noexcept;  // NOLINT
+  constexpr ElementType* end() const noexcept;    // NOLINT
+
+ private:
+  constexpr void CheckTiling() const;
+};
+
+template <class T, class Layout>
+constexpr ArrayView<T, Layout>::ArrayView(T& array) noexcept requires(kIsStatic)
+    : data_(detail::FirstElement(array)), leading_(kExtents[0]) {
+  CheckTiling();
+}
+
+template <class T, class Layout>
+constexpr ArrayView<T, Layout>::ArrayView(ElementType* data) requires(kIsStatic)
+    : data_(data), leading_(kExtents[0]) {
+  CheckTiling();
+}
+
+template <class T, class Layout>
+constexpr ArrayView<T, Layout>::ArrayView(ElementType* data, size_t leading) requires(!kIsStatic)
+    : data_(data), leading_(leading) {
+  CheckTiling();
+}
+
+// Tiles have to cover the last two dimensions exactly. Static extents are checked at compile time, a dynamic
+// leading extent that is tiled (rank 2) when the view is made.
+template <class T, class Layout>
+constexpr void ArrayView<T, Layout>::CheckTiling() const {
+  if constexpr (detail::IsTiled<Layout>::value) {
+    []<size_t kTileRows, size_t kTileCols>(Tiled<kTileRows, kTileCols>) {
+      static_assert(kRank >= 2 && kTileRows > 0 && kTileCols > 0, "tiling needs two dimensions");
+      static_assert(kExtents[kRank - 1] % kTileCols == 0, "columns must be a multiple of the tile width");
+      static_assert(kExtents[kRank - 2] % kTileRows == 0, "rows must be a multiple of the tile height");
+    }(Layout{});
+    if (kRank == 2 && !kIsStatic) {
+      [this]<size_t kTileRows, size_t kTileCols>(Tiled<kTileRows, kTileCols>) {
+        if (leading_ % kTileRows != 0) {
+          throw std::invalid_argument("BadExtent");
+        }
+      }(Layout{});
+    }
+  }
+}
+
+template <class T, class Layout>
+constexpr size_t ArrayView<T, Layout>::Extent(size_t dim) const noexcept {
+  return dim == 0 ? leading_ : kExtents[dim];
+}
+
+// Distance in elements between neighbours along dim.
+template <class T, class Layout>
+constexpr size_t ArrayView<T, Layout>::Stride(size_t dim) const noexcept requires(!detail::IsTiled<Layout>::value) {
+  size_t stride = 1;
+  if constexpr (std::is_same_v<Layout, ColumnMajor>) {
+    for (size_t d = 0; d < dim; ++d) {
+      stride *= Extent(d);
+    }
+  } else {
+    for (size_t d = dim + 1; d < kRank; ++d) {
+      stride *= kExtents[d];
+    }
+  }
+  return stride;
+}
+
+template <class T, class Layout>
+constexpr size_t ArrayView<T, Layout>::Size() const noexcept {
+  if constexpr (kIsStatic) {
+    return kTotalSizeV<T>;
+  } else {
+    return leading_ * kTotalSizeV<RemoveArrayT<T>>;
+  }
+}
+
+template <class T, class Layout>
+constexpr typename ArrayView<T, Layout>::ElementType* ArrayView<T, Layout>::Data() const noexcept {
+  return data_;
+}
+
+template <class T, class Layout>
+template <class... Indices>
+constexpr typename ArrayView<T, Layout>::ElementType&
+ArrayView<T, Layout>::operator()(Indices... indices) const noexcept requires(sizeof...(Indices) == kRank) {
+  const std::array<size_t, kRank> idx{static_cast<size_t>(indices)...};
+  size_t offset = 0;
+  if constexpr (std::is_same_v<Layout, ColumnMajor>) {
+    for (size_t d = kRank; d-- > 0;) {
+      offset = offset * Extent(d) + idx[d];
+    }
+  } else if constexpr (std::is_same_v<Layout, RowMajor>) {
+    for (size_t d = 0; d < kRank; ++d) {
+      offset = offset * Extent(d) + idx[d];
+    }
+  } else {
+    offset = [&]<size_t kTileRows, size_t kTileCols>(Tiled<kTileRows, kTileCols>) {
+      size_t outer = 0;
+      for (size_t d = 0; d + 2 < kRank; ++d) {
+        outer = outer * Extent(d) + idx[d];
+      }
+      auto rows = Extent(kRank - 2);
+      constexpr auto kCols = kExtents[kRank - 1];
+      auto row = idx[kRank - 2];
+      auto col = idx[kRank - 1];
+      auto tile = row / kTileRows * (kCols / kTileCols) + col / kTileCols;
+      return outer * rows * kCols + tile * (kTileRows * kTileCols) + row % kTileRows * kTileCols + col % kTileCols;
+    }(Layout{});
+  }
+  return data_[offset];
+}
+
+// All Size() elements in storage order; with static extents the span has a static extent as well.
+template <class T, class Layout>
+constexpr std::span<typename ArrayView<T, Layout>::ElementType, ArrayView<T, Layout>::kIsStatic ? kTotalSizeV<T>
+                                                                                                 : std::dynamic_extent>
+ArrayView<T, Layout>::Flat() const noexcept {
+  if constexpr (kIsStatic) {
+    return std::span<ElementType, kTotalSizeV<T>>(data_, kTotalSizeV<T>);
+  } else {
+    return {data_, Size()};
+  }
+}
+
+template <class T, class Layout>
+constexpr typename ArrayView<T, Layout>::ElementType* ArrayView<T, Layout>::begin() const noexcept {
+  return data_;
+}
+
+template <class T, class Layout>
+constexpr typename ArrayView<T, Layout>::ElementType* ArrayView<T, Layout>::end() const noexcept {
+  return data_ + Size();
+}
+
+// Elementwise kernels over views of the same shape and layout. Both walk the flat storage in blocks of
+// kKernelBlock elements whose bodies are unrolled at compile time; for static extents the block count is a
+// constant too, so the whole loop has a known trip count.
+namespace detail {
+constexpr size_t kKernelBlock = 8;
+
+template <class T, class U, class Layout>
+constexpr void CheckSameShape(const ArrayView<T, Layout>& lhs, const ArrayView<U, Layout>& rhs) {
+  static_assert(ArrayView<T, Layout>::kRank == ArrayView<U, Layout>::kRank, "views differ in rank");
+  for (size_t d = 0; d < ArrayView<T, Layout>::kRank; ++d) {
+    if (lhs.Extent(d) != rhs.Extent(d)) {
+      throw std::invalid_argument("BadExtent");
+    }
+  }
+}
+}  // namespace detail
+
+// out[i] = f(in[i]...) for every element.
+template <class F, class T, class Layout, class... Us>
+constexpr void Map(F f, const ArrayView<T, Layout>& out, const ArrayView<Us, Layout>&... in) {
+  (detail::CheckSameShape(out, in), ...);
+  auto size = out.Size();
+  auto dst = out.Data();
+  size_t base = 0;
+  for (; base + detail::kKernelBlock <= size; base += detail::kKernelBlock) {
+    detail::Unrolled<detail::kKernelBlock>([&](auto i) { dst[base + i] = f(in.Data()[base + i]...); });
+  }
+  for (; base < size; ++base) {
+    dst[base] = f(in.Data()[base]...);
+  }
+}
+
+// Combines init with every element by op, which has to be associative and commutative: the elements are
+// folded into kKernelBlock independent partial results first, which breaks the dependency chain of a single
+// accumulator and lets floating-point sums vectorize without -ffast-math.
+template <class T, class Layout, class Init, class Op>
+constexpr Init Reduce(const ArrayView<T, Layout>& view, Init init, Op op) {
+  auto size = view.Size();
+  auto src = view.Data();
+  if (size < detail::kKernelBlock) {
+    for (size_t i = 0; i < size; ++i) {
+      init = op(init, src[i]);
+    }
+    return init;
+  }
+  std::array<Init, detail::kKernelBlock> partial{};
+  detail::Unrolled<detail::kKernelBlock>([&](auto i) { partial[i] = static_cast<Init>(src[i]); });
+  size_t base = detail::kKernelBlock;
+  for (; base + detail::kKernelBlock <= size; base += detail::kKernelBlock) {
+    detail::Unrolled<detail::kKernelBlock>([&](auto i) { partial[i] = op(partial[i], src[base + i]); });
+  }
+  for (size_t i = 0; base < size; ++base, ++i) {
+    partial[i] = op(partial[i], src[base]);
+  }
+  detail::Unrolled<detail::kKernelBlock>([&](auto i) { init = op(init, partial[i]); });
+  return init;
+}
@@ -2,6 +2,10 @@
 
 #include <type_traits>
 #include <cstddef>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 
 template <size_t Left, size_t Right, size_t N, size_t Mid = (Left + Right) / 2>
 struct Sqrt : std::integral_constant<size_t, std::conditional_t<(Mid * Mid <= N && (Mid < 1'000'000'000)),
@@ -38,5 +42,181 @@ struct HasDivisorOn<N, Value, Value + 1> : std::bool_constant<(N % Value == 0) |
 template <size_t N, size_t L, size_t R>
 constexpr inline bool kHasDivisorOnV = HasDivisorOn<N, L, R>::value;
 
+// Function engine for large N: the templates above instantiate O(sqrt(N)) classes, these run in the constant
+// evaluator in O(log N) steps.
+
+// Largest s with s * s <= n; Newton's iteration from a power of two that is not below the root.
+constexpr uint64_t IntegerSqrt(uint64_t n) {
+  if (n < 2) {
+    return n;
+  }
+  auto x = uint64_t{1} << ((std::bit_width(n) + 1) / 2);
+  while (true) {
+    auto y = (x + n / x) / 2;
+    if (y >= x) {
+      return x;
+    }
+    x = y;
+  }
+}
+
+namespace detail {
+constexpr uint64_t MulMod(uint64_t a, uint64_t b, uint64_t mod) {
+  return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % mod);
+}
+
+constexpr uint64_t PowMod(uint64_t base, uint64_t exp, uint64_t mod) {
+  uint64_t result = 1;
+  base %= mod;
+  for (; exp != 0; exp >>= 1) {
+    if (exp & 1) {
+      result = MulMod(result, base, mod);
+    }
+    base = MulMod(base, base, mod);
+  }
+  return result;
+}
+
+// One Miller-Rabin round for odd n - 1 = d * 2^s: false if base proves n composite.
+constexpr bool PassesMillerRabin(uint64_t n, uint64_t d, int s, uint64_t base) {
+  auto x = PowMod(base, d, n);
+  if (x == 1 || x == n - 1) {
+    return true;
+  }
+  for (int i = 1; i < s; ++i) {
+    x = MulMod(x, x, n);
+    if (x == n - 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+constexpr uint64_t kSmallPrimes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+}  // namespace detail
+
+// Deterministic for every 64-bit n: the first twelve primes as bases leave no strong pseudoprime below 2^64.
+constexpr bool IsPrime(uint64_t n) {
+  if (n < 2) {
+    return false;
+  }
+  for (auto p : detail::kSmallPrimes) {
+    if (n % p == 0) {
+      return n == p;
+    }
+  }
+  auto d = n - 1;
+  auto s = std::countr_zero(d);
+  d >>= s;
+  for (auto base : detail::kSmallPrimes) {
+    if (!detail::PassesMillerRabin(n, d, s, base)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <size_t N>
+constexpr inline bool kIsPrimeV = IsPrime(N);
+
+// Smallest prime not below n; n must not exceed the largest 64-bit prime, 2^64 - 59.
+constexpr uint64_t NextPrime(uint64_t n) {
+  while (!IsPrime(n)) {
+    ++n;
+  }
+  return n;
+}
+
+template <size_t N>
+constexpr inline uint64_t kNextPrimeV = NextPrime(N);
+
+namespace detail {
+// Loops in the constant evaluator are limited to 2^18 iterations each (GCC's -fconstexpr-loop-limit), so every
+// pass over [0, N] below runs block by block.
+constexpr size_t kSieveBlock = size_t{1} << 16;
+
+// composite[i] for every odd 2 * i + 1 <= N, by the sieve of Eratosthenes over odd numbers only.
+template <size_t N>
+constexpr std::array<bool, N / 2 + 1> SieveOddUpTo() {
+  std::array<bool, N / 2 + 1> composite{};
+  composite[0] = true;
+  for (size_t low = 0; low <= N / 2; low += kSieveBlock) {
+    auto high = std::min(N / 2, low + kSieveBlock - 1);
+    for (size_t i = 1; (2 * i + 1) * (2 * i + 1) <= 2 * high + 1; ++i) {
+      if (!composite[i]) {
+        auto p = 2 * i + 1;
+        auto first = (p * p) / 2;
+        if (first < low) {
+          first += (low - first + p - 1) / p * p;
+        }
+        for (auto multiple = first; multiple <= high; multiple += p) {
+          composite[multiple] = true;
+        }
+      }
+    }
+  }
+  return composite;
+}
+
+// Calls visit(p) for every prime p <= N in increasing order.
+template <size_t N, class Visit>
+constexpr void ForEachPrimeUpTo(Visit visit) {
+  if (N < 2) {
+    return;
+  }
+  visit(2);
+  auto composite = SieveOddUpTo<N>();
+  for (size_t low = 0; low <= N / 2; low += kSieveBlock) {
+    for (size_t i = low; i <= std::min(N / 2, low + kSieveBlock - 1); ++i) {
+      if (!composite[i] && 2 * i + 1 <= N) {
+        visit(2 * i + 1);
+      }
+    }
+  }
+}
+
+template <size_t N>
+constexpr size_t CountPrimesUpTo() {
+  size_t count = 0;
+  ForEachPrimeUpTo<N>([&count](size_t) { ++count; });
+  return count;
+}
+
+template <size_t N, size_t Count>
+constexpr std::array<uint64_t, Count> PrimesUpTo() {
+  std::array<uint64_t, Count> primes{};
+  size_t count = 0;
+  ForEachPrimeUpTo<N>([&primes, &count](size_t p) { primes[count++] = p; });
+  return primes;
+}
+
+constexpr std::array<uint64_t, 64> MakePrimeLadder() {
+  std::array<uint64_t, 64> ladder{};
+  for (int i = 0; i < 63; ++i) {
+    ladder[i] = NextPrime(uint64_t{2} << i);
+  }
+  ladder[63] = 18446744073709551557ULL;
+  return ladder;
+}
+}  // namespace detail
+
+// All primes up to N in increasing order. The sieve runs in the constant evaluator, so N is bounded by the
+// compiler's constexpr operation limit: about 3 * 10^5 with the GCC defaults, more with -fconstexpr-ops-limit.
+template <size_t N>
+constexpr inline size_t kPrimeCountV = detail::CountPrimesUpTo<N>();
+
 template <size_t N>
-constexpr inline bool kIsPrimeV = !kHasDivisorOnV<N, 2, kSqrtV<N>>;
+constexpr inline std::array<uint64_t, kPrimeCountV<N>> kPrimesUpToV = detail::PrimesUpTo<N, kPrimeCountV<N>>();
+
+// Hash table sizes: the first prime not below each power of two from 2 to 2^63, then the largest 64-bit prime.
+constexpr inline std::array<uint64_t, 64> kPrimeLadder = detail::MakePrimeLadder();
+
+// First ladder prime not below capacity (the last one for anything larger, which no table can hold anyway).
+// Branchless lower bound over the 64 entries: six compare-and-advance steps, none of which branches on data.
+constexpr uint64_t LadderPrimeAtLeast(uint64_t capacity) {
+  const uint64_t* base = kPrimeLadder.data();
+  for (size_t len = kPrimeLadder.size(); len > 1; len -= len / 2) {
+    base += static_cast<size_t>(base[len / 2 - 1] < capacity) * (len / 2);
+  }
+  return *base;
+}
@@ -0,0 +1,33 @@
+// Compile-time cost of kIsPrimeV against the template engine it replaced (kHasDivisorOnV up to kSqrtV), on
+// N - 2, N and N + 2. The benchmark is the compilation itself:
+//
+//   /usr/bin/time -f "%e s, %M KiB" g++ -std=c++20 -fsyntax-only isprime_build_bench.cpp
+//   /usr/bin/time -f "%e s, %M KiB" g++ -std=c++20 -fsyntax-only -DTEMPLATE_ENGINE isprime_build_bench.cpp
+//
+// N defaults to 10^9 + 7; pass -DBENCH_N=... for other sizes. The template engine instantiates O(sqrt(N))
+// classes, so its time and memory grow with sqrt(N); the function engine's stay flat up to 2^64.
+
+#include <cstdint>
+
+#include "isprime.hpp"
+
+#ifndef BENCH_N
+#define BENCH_N 1'000'000'007
+#endif
+
+constexpr size_t kN = BENCH_N;
+
+#ifdef TEMPLATE_ENGINE
+template <size_t Value>
+constexpr inline bool kIsPrimeCheckV = !kHasDivisorOnV<Value, 2, kSqrtV<Value>>;
+#else
+template <size_t Value>
+constexpr inline bool kIsPrimeCheckV = kIsPrimeV<Value>;
+#endif
+
+static_assert(kIsPrimeCheckV<kN> == IsPrime(kN));
+static_assert(kIsPrimeCheckV<kN - 2> == IsPrime(kN - 2));
+static_assert(kIsPrimeCheckV<kN + 2> == IsPrime(kN + 2));
+
+int main() {
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "isprime.hpp"
+
+// Runtime counterpart of kIsPrimeV for ranges: a segmented sieve of Eratosthenes over the wheel mod 30. Each
+// byte of a segment covers 30 consecutive numbers, bit j standing for 30 * byte + kWheel[j], so multiples of 2, 3
+// and 5 take no space and a segment of kSegmentBytes stays in L2. Ranges are half-open, [lo, hi).
+//
+// The arithmetic holds for any hi below 2^64, but memory grows with the number of sieving primes up to sqrt(hi):
+// 4 bytes each, plus 64 bytes each per sieving thread for the positions carried between segments. That is about
+// 5 MB per thread for hi = 10^12 and 400 MB per thread for hi = 10^16; near 2^64 it would be over 13 GB, so
+// single numbers that large belong to IsPrime(uint64_t).
+
+namespace detail {
+constexpr uint64_t kWheel[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+constexpr size_t kSegmentBytes = size_t{1} << 18;
+constexpr size_t kBootstrapLimit = size_t{1} << 16;
+
+// Bit of residue r mod 30 within a byte, or 8 if r is not coprime to 30.
+constexpr std::array<uint8_t, 30> kWheelBit = [] {
+  std::array<uint8_t, 30> bits{};
+  bits.fill(8);
+  for (uint8_t j = 0; j < 8; ++j) {
+    bits[kWheel[j]] = j;
+  }
+  return bits;
+}();
+
+// Bits of byte whose numbers are not below lo. The last byte below 2^64 reaches past it, so the comparison is
+// made on the offset from the byte's first number.
+inline uint8_t WheelMaskFrom(uint64_t byte, uint64_t lo) {
+  auto base = 30 * byte;
+  uint8_t mask = 0;
+  for (int j = 0; j < 8; ++j) {
+    mask |= static_cast<uint8_t>((lo <= base || lo - base <= kWheel[j]) << j);
+  }
+  return mask;
+}
+
+// One past the wheel byte holding hi - 1, for hi >= 1; (hi + 29) / 30 would wrap near 2^64.
+inline uint64_t EndByte(uint64_t hi) {
+  return (hi - 1) / 30 + 1;
+}
+
+// Primes from 7 up to limit < 2^32. Those below kBootstrapLimit come from the compile-time table, the rest from
+// a plain sieve seeded with it, run over windows of kSegmentBytes numbers so that only the primes themselves
+// take memory proportional to limit.
+inline std::vector<uint32_t> SievingPrimes(uint64_t limit) {
+  std::vector<uint32_t> primes;
+  for (auto p : kPrimesUpToV<kBootstrapLimit>) {
+    if (p >= 7 && p <= limit) {
+      primes.push_back(static_cast<uint32_t>(p));
+    }
+  }
+  std::vector<uint8_t> composite(limit > kBootstrapLimit ? kSegmentBytes : 0);
+  for (uint64_t low = kBootstrapLimit + 1; low <= limit; low += kSegmentBytes) {
+    auto high = std::min<uint64_t>(limit, low + kSegmentBytes - 1);
+    std::fill_n(composite.begin(), high - low + 1, 0);
+    for (auto p : kPrimesUpToV<kBootstrapLimit>) {
+      if (p * p > high) {
+        break;
+      }
+      for (auto multiple = std::max(p * p, (low + p - 1) / p * p); multiple <= high; multiple += p) {
+        composite[multiple - low] = 1;
+      }
+    }
+    for (auto n = low; n <= high; ++n) {
+      if (!composite[n - low]) {
+        primes.push_back(static_cast<uint32_t>(n));
+      }
+    }
+  }
+  return primes;
+}
+
+// Sieves consecutive segments of wheel bytes. For every sieving prime p and wheel residue k mod 30, the
+// multiples p * k hit one fixed bit every p bytes, so the state is the next byte of each of these eight
+// progressions, carried from one segment to the next.
+class WheelSegmentSieve {
+  const std::vector<uint32_t>& primes_;
+  std::vector<uint64_t> next_;
+
+ public:
+  WheelSegmentSieve(const std::vector<uint32_t>& primes, uint64_t first_byte)
+      : primes_(primes), next_(8 * primes.size()) {
+    for (size_t i = 0; i < primes_.size(); ++i) {
+      uint64_t p = primes_[i];
+      auto first = 30 * first_byte;
+      auto k_min = std::max(p, first / p + (first % p != 0));
+      for (int j = 0; j < 8; ++j) {
+        auto k = k_min + (kWheel[j] + 30 - k_min % 30) % 30;
+        next_[8 * i + j] = static_cast<uint64_t>(static_cast<unsigned __int128>(p) * k / 30);
+      }
+    }
+  }
+
+  // Marks the primes among bytes [first_byte, first_byte + size); calls must follow each other without gaps.
+  void Sieve(uint8_t* segment, uint64_t first_byte, size_t size) {
+    std::memset(segment, 0xFF, size);
+    if (first_byte == 0) {
+      segment[0] &= 0xFE;
+    }
+    auto end = first_byte + size;
+    for (size_t i = 0; i < primes_.size(); ++i) {
+      uint64_t p = primes_[i];
+      for (int j = 0; j < 8; ++j) {
+        auto mask = static_cast<uint8_t>(~(1u << kWheelBit[p * kWheel[j] % 30]));
+        auto byte = next_[8 * i + j];
+        for (; byte < end; byte += p) {
+          segment[byte - first_byte] &= mask;
+        }
+        next_[8 * i + j] = byte;
+      }
+    }
+  }
+};
+
+inline size_t CountBits(const uint8_t* bytes, size_t size) {
+  size_t count = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    count += static_cast<size_t>(std::popcount(word));
+  }
+  for (; i < size; ++i) {
+    count += static_cast<size_t>(std::popcount(bytes[i]));
+  }
+  return count;
+}
+
+// Calls visit(segment, first_byte, size) for the wheel bytes covering [lo, hi) in order, with the numbers
+// outside the range already cleared.
+template <class Visit>
+void ForEachSegment(const std::vector<uint32_t>& primes, uint64_t first_byte, uint64_t end_byte, uint64_t lo,
+                    uint64_t hi, Visit visit) {
+  std::vector<uint8_t> segment(kSegmentBytes);
+  WheelSegmentSieve sieve(primes, first_byte);
+  for (auto byte = first_byte; byte < end_byte; byte += kSegmentBytes) {
+    auto size = static_cast<size_t>(std::min<uint64_t>(kSegmentBytes, end_byte - byte));
+    sieve.Sieve(segment.data(), byte, size);
+    segment[0] &= WheelMaskFrom(byte, lo);
+    segment[size - 1] &= static_cast<uint8_t>(~WheelMaskFrom(byte + size - 1, hi));
+    visit(segment.data(), byte, size);
+  }
+}
+
+inline uint64_t SmallPrimesIn(uint64_t lo, uint64_t hi) {
+  uint64_t count = 0;
+  for (uint64_t p : {2, 3, 5}) {
+    count += (lo <= p && p < hi) ? 1 : 0;
+  }
+  return count;
+}
+}  // namespace detail
+
+// Number of primes in [lo, hi), sieved by up to threads threads (0 means one per hardware thread), each over
+// its own run of segments.
+inline uint64_t CountPrimes(uint64_t lo, uint64_t hi, size_t threads = 0) {
+  if (lo >= hi) {
+    return 0;
+  }
+  auto count = detail::SmallPrimesIn(lo, hi);
+  auto primes = detail::SievingPrimes(IntegerSqrt(hi - 1));
+  auto first_byte = lo / 30;
+  auto end_byte = detail::EndByte(hi);
+  auto segments = (end_byte - first_byte + detail::kSegmentBytes - 1) / detail::kSegmentBytes;
+  threads = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+  threads = static_cast<size_t>(std::min<uint64_t>(threads, segments));
+  std::vector<uint64_t> counts(threads);
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    auto begin = first_byte + segments * t / threads * detail::kSegmentBytes;
+    auto end = std::min(end_byte, first_byte + segments * (t + 1) / threads * detail::kSegmentBytes);
+    auto run = [&primes, &counts, t, begin, end, lo, hi] {
+      detail::ForEachSegment(primes, begin, end, lo, hi, [&counts, t](const uint8_t* segment, uint64_t, size_t size) {
+        counts[t] += detail::CountBits(segment, size);
+      });
+    };
+    if (t + 1 == threads) {
+      run();
+    } else {
+      workers.emplace_back(run);
+    }
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (auto c : counts) {
+    count += c;
+  }
+  return count;
+}
+
+// Calls visit(p) for every prime p in [lo, hi) in increasing order, one segment at a time on the calling thread.
+template <class Visit>
+void ForEachPrime(uint64_t lo, uint64_t hi, Visit visit) {
+  if (lo >= hi) {
+    return;
+  }
+  for (uint64_t p : {2, 3, 5}) {
+    if (lo <= p && p < hi) {
+      visit(p);
+    }
+  }
+  auto primes = detail::SievingPrimes(IntegerSqrt(hi - 1));
+  detail::ForEachSegment(primes, lo / 30, detail::EndByte(hi), lo, hi,
+                         [&visit](const uint8_t* segment, uint64_t first_byte, size_t size) {
+                           for (size_t i = 0; i < size; ++i) {
+                             for (unsigned bits = segment[i]; bits != 0; bits &= bits - 1) {
+                               visit(30 * (first_byte + i) + detail::kWheel[std::countr_zero(bits)]);
+                             }
+                           }
+                         });
+}
+
+// Batch query: result[i] = IsPrime(values[i]). Values that are dense enough are answered from one sieve of their
+// span, sparse ones by Miller-Rabin each. The sieve's cost counts its sieving primes up to sqrt(max) too, so large
+// values fall back to Miller-Rabin unless there are very many of them.
+inline void IsPrime(std::span<const uint64_t> values, std::span<bool> result) {
+  if (values.empty()) {
+    return;
+  }
+  auto [min, max] = std::minmax_element(values.begin(), values.end());
+  auto lo = *min;
+  auto hi = *max + 1;
+  if (hi == 0 || ((hi - lo) / 30 + IntegerSqrt(hi - 1)) / 8 > values.size()) {
+    for (size_t i = 0; i < values.size(); ++i) {
+      result[i] = IsPrime(values[i]);
+    }
+    return;
+  }
+  auto first_byte = lo / 30;
+  std::vector<uint8_t> bitmap(detail::EndByte(hi) - first_byte);
+  auto primes = detail::SievingPrimes(IntegerSqrt(hi - 1));
+  detail::ForEachSegment(primes, first_byte, first_byte + bitmap.size(), lo, hi,
+                         [&bitmap, first_byte](const uint8_t* segment, uint64_t byte, size_t size) {
+                           std::memcpy(bitmap.data() + (byte - first_byte), segment, size);
+                         });
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto n = values[i];
+    auto bit = detail::kWheelBit[n % 30];
+    result[i] = bit == 8 ? (n == 2 || n == 3 || n == 5) : ((bitmap[n / 30 - first_byte] >> bit) & 1) != 0;
+  }
+}
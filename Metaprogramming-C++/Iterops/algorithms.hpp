@@ -0,0 +1,245 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "iterops.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ITEROPS_HAS_AVX2_KERNELS
+#endif
+
+// Bulk algorithms that pick their implementation at compile time the way Distance and Advance do: contiguous
+// ranges of trivially copyable values go to memmove/memset/memcmp/memchr or an AVX2 kernel, everything else to
+// the plain loop.
+
+namespace detail {
+template <class Iterator>
+using ValueT = typename std::iterator_traits<Iterator>::value_type;
+
+// Contiguous range of trivially copyable values that can be handled as raw bytes.
+template <class Iterator>
+constexpr inline bool kIsRawRangeV =
+    std::contiguous_iterator<Iterator> && std::is_trivially_copyable_v<ValueT<Iterator>>;
+
+// Values whose equality is equality of their bytes, so a search may compare bits.
+template <class T>
+constexpr inline bool kIsBitComparableV =
+    (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+template <class Iterator, class Value>
+constexpr inline bool kIsSearchableV = std::contiguous_iterator<Iterator> &&
+                                       kIsBitComparableV<ValueT<Iterator>> &&
+                                       std::is_same_v<std::remove_cv_t<Value>, ValueT<Iterator>>;
+
+template <class T>
+bool HasUniformBytes(const T& value) {
+  unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  for (size_t i = 1; i < sizeof(T); ++i) {
+    if (bytes[i] != bytes[0]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class T>
+size_t FindScalar(const T* data, size_t n, T value) noexcept {
+  size_t i = 0;
+  while (i < n && data[i] != value) {
+    ++i;
+  }
+  return i;
+}
+
+template <class T>
+size_t CountScalar(const T* data, size_t n, T value) noexcept {
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    count += data[i] == value ? 1 : 0;
+  }
+  return count;
+}
+
+#ifdef ITEROPS_HAS_AVX2_KERNELS
+// Lanes equal to value in a 32-byte chunk, as a byte mask with sizeof(T) bits set per matching element.
+template <class T>
+__attribute__((target("avx2"))) inline unsigned MatchMask(const T* data, __m256i needle) noexcept {
+  auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+  __m256i equal;
+  if constexpr (sizeof(T) == 1) {
+    equal = _mm256_cmpeq_epi8(chunk, needle);
+  } else if constexpr (sizeof(T) == 2) {
+    equal = _mm256_cmpeq_epi16(chunk, needle);
+  } else if constexpr (sizeof(T) == 4) {
+    equal = _mm256_cmpeq_epi32(chunk, needle);
+  } else {
+    equal = _mm256_cmpeq_epi64(chunk, needle);
+  }
+  return static_cast<unsigned>(_mm256_movemask_epi8(equal));
+}
+
+template <class T>
+__attribute__((target("avx2"))) inline __m256i Broadcast(T value) noexcept {
+  if constexpr (sizeof(T) == 1) {
+    return _mm256_set1_epi8(std::bit_cast<char>(value));
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_set1_epi16(std::bit_cast<short>(value));  // NOLINT
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm256_set1_epi32(std::bit_cast<int>(value));
+  } else {
+    return _mm256_set1_epi64x(std::bit_cast<long long>(value));  // NOLINT
+  }
+}
+
+template <class T>
+__attribute__((target("avx2"))) inline size_t FindAvx2(const T* data, size_t n, T value) noexcept {
+  constexpr size_t kLanes = 32 / sizeof(T);
+  auto needle = Broadcast(value);
+  size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    if (auto mask = MatchMask(data + i, needle)) {
+      return i + static_cast<size_t>(std::countr_zero(mask)) / sizeof(T);
+    }
+  }
+  return i + FindScalar(data + i, n - i, value);
+}
+
+// Sums the matching lanes of four chunks before reducing the masks, so there is one popcount per 128 bytes.
+template <class T>
+__attribute__((target("avx2,popcnt"))) inline size_t CountAvx2(const T* data, size_t n, T value) noexcept {
+  constexpr size_t kLanes = 32 / sizeof(T);
+  auto needle = Broadcast(value);
+  size_t bits = 0;
+  size_t i = 0;
+  for (; i + 4 * kLanes <= n; i += 4 * kLanes) {
+    uint64_t low = MatchMask(data + i, needle) | uint64_t{MatchMask(data + i + kLanes, needle)} << 32;
+    uint64_t high = MatchMask(data + i + 2 * kLanes, needle) | uint64_t{MatchMask(data + i + 3 * kLanes, needle)} << 32;
+    bits += static_cast<size_t>(std::popcount(low) + std::popcount(high));
+  }
+  for (; i + kLanes <= n; i += kLanes) {
+    bits += static_cast<size_t>(std::popcount(MatchMask(data + i, needle)));
+  }
+  return bits / sizeof(T) + CountScalar(data + i, n - i, value);
+}
+#endif
+
+template <class T>
+size_t FindRaw(const T* data, size_t n, T value) noexcept {
+  if constexpr (sizeof(T) == 1) {
+    auto hit = static_cast<const T*>(std::memchr(data, std::bit_cast<unsigned char>(value), n));
+    return hit ? static_cast<size_t>(hit - data) : n;
+  } else {
+#ifdef ITEROPS_HAS_AVX2_KERNELS
+    static const bool kHasAvx2 = __builtin_cpu_supports("avx2");
+    if (kHasAvx2) {
+      return FindAvx2(data, n, value);
+    }
+#endif
+    return FindScalar(data, n, value);
+  }
+}
+
+template <class T>
+size_t CountRaw(const T* data, size_t n, T value) noexcept {
+#ifdef ITEROPS_HAS_AVX2_KERNELS
+  static const bool kHasAvx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+  if (kHasAvx2) {
+    return CountAvx2(data, n, value);
+  }
+#endif
+  return CountScalar(data, n, value);
+}
+}  // namespace detail
+
+// Overlapping ranges are allowed on the memmove path only; the loop needs out outside of [begin, end).
+template <class InputIterator, class OutputIterator>
+OutputIterator Copy(InputIterator begin, InputIterator end, OutputIterator out) {
+  if constexpr (detail::kIsRawRangeV<InputIterator> && detail::kIsRawRangeV<OutputIterator> &&
+                std::is_same_v<detail::ValueT<InputIterator>, detail::ValueT<OutputIterator>>) {
+    auto n = Distance(begin, end);
+    if (n > 0) {
+      std::memmove(std::to_address(out), std::to_address(begin),
+                   static_cast<size_t>(n) * sizeof(detail::ValueT<InputIterator>));
+    }
+    return Next(out, n);
+  } else {
+    for (; begin != end; ++begin, ++out) {
+      *out = *begin;
+    }
+    return out;
+  }
+}
+
+// Values made of one repeated byte, zero above all, are written with memset.
+template <class Iterator, class T>
+void Fill(Iterator begin, Iterator end, const T& value) {
+  if constexpr (detail::kIsRawRangeV<Iterator> && std::is_same_v<std::remove_cv_t<T>, detail::ValueT<Iterator>>) {
+    if (detail::HasUniformBytes(value)) {
+      auto n = Distance(begin, end);
+      if (n > 0) {
+        unsigned char byte;
+        std::memcpy(&byte, &value, 1);
+        std::memset(std::to_address(begin), byte, static_cast<size_t>(n) * sizeof(T));
+      }
+      return;
+    }
+  }
+  for (; begin != end; ++begin) {
+    *begin = value;
+  }
+}
+
+// Integers, enums and pointers, whose operator== compares their bytes, are compared with memcmp. Classes are
+// not, even without padding: their operator== may ignore members or compare them some other way.
+template <class Iterator1, class Iterator2>
+bool Equal(Iterator1 begin1, Iterator1 end1, Iterator2 begin2) {
+  using T = detail::ValueT<Iterator1>;
+  if constexpr (std::contiguous_iterator<Iterator1> && std::contiguous_iterator<Iterator2> &&
+                std::is_same_v<T, detail::ValueT<Iterator2>> && detail::kIsBitComparableV<T>) {
+    auto n = Distance(begin1, end1);
+    return n <= 0 ||
+           std::memcmp(std::to_address(begin1), std::to_address(begin2), static_cast<size_t>(n) * sizeof(T)) == 0;
+  } else {
+    for (; begin1 != end1; ++begin1, ++begin2) {
+      if (!(*begin1 == *begin2)) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+template <class Iterator, class T>
+Iterator Find(Iterator begin, Iterator end, const T& value) {
+  if constexpr (detail::kIsSearchableV<Iterator, T>) {
+    auto n = static_cast<size_t>(Distance(begin, end));
+    return Next(begin, static_cast<detail::DifferenceT<Iterator>>(detail::FindRaw(std::to_address(begin), n, value)));
+  } else {
+    while (begin != end && !(*begin == value)) {
+      ++begin;
+    }
+    return begin;
+  }
+}
+
+template <class Iterator, class T>
+typename std::iterator_traits<Iterator>::difference_type Count(Iterator begin, Iterator end, const T& value) {
+  if constexpr (detail::kIsSearchableV<Iterator, T>) {
+    auto n = static_cast<size_t>(Distance(begin, end));
+    return static_cast<detail::DifferenceT<Iterator>>(detail::CountRaw(std::to_address(begin), n, value));
+  } else {
+    typename std::iterator_traits<Iterator>::difference_type n = 0;
+    for (; begin != end; ++begin) {
+      n += *begin == value ? 1 : 0;
+    }
+    return n;
+  }
+}
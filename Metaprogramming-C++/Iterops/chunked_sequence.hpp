@@ -0,0 +1,219 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "iterops.hpp"
+
+// Rope-like sequence: a list of contiguous chunks. PushBack fills chunks of the size given at construction,
+// AppendChunk splices in a whole vector as one more chunk. Iterators are bidirectional only, but they are
+// segmented: SegmentedIteratorTraits splits them into the chunk and a pointer inside it, so Distance, Advance,
+// Next and Prev cost O(chunks).
+//
+// The list always ends in an empty sentinel chunk, and end() points into it. A position therefore never rests on
+// the end of a real chunk, which gives every element one representation and lets Compose normalize End(chunk)
+// without knowing the list.
+template <class T>
+class ChunkedSequence;
+
+template <class Value>
+class ChunkedIterator {
+  using T = std::remove_const_t<Value>;
+  using Chunks = std::list<std::vector<T>>;
+
+ public:
+  using ChunkIterator =
+      std::conditional_t<std::is_const_v<Value>, typename Chunks::const_iterator, typename Chunks::iterator>;
+
+  using iterator_category = std::bidirectional_iterator_tag;  // NOLINT
+  using value_type = T;                                        // NOLINT
+  using difference_type = ptrdiff_t;                           // NOLINT
+  using reference = Value&;                                    // NOLINT
+  using pointer = Value*;                                      // NOLINT
+
+  ChunkedIterator() noexcept = default;
+  ChunkedIterator(ChunkIterator chunk, Value* pos) noexcept : chunk_(chunk), pos_(pos) {
+  }
+  operator ChunkedIterator<const T>() const noexcept requires(!std::is_const_v<Value>) {  // NOLINT
+    return {chunk_, pos_};
+  }
+
+  Value& operator*() const noexcept {
+    return *pos_;
+  }
+  Value* operator->() const noexcept {
+    return pos_;
+  }
+  ChunkedIterator& operator++() noexcept {
+    if (++pos_ == chunk_->data() + chunk_->size()) {
+      ++chunk_;
+      pos_ = chunk_->data();
+    }
+    return *this;
+  }
+  ChunkedIterator operator++(int) noexcept {
+    auto old = *this;
+    ++*this;
+    return old;
+  }
+  ChunkedIterator& operator--() noexcept {
+    if (pos_ == chunk_->data()) {
+      --chunk_;
+      pos_ = chunk_->data() + chunk_->size();
+    }
+    --pos_;
+    return *this;
+  }
+  ChunkedIterator operator--(int) noexcept {
+    auto old = *this;
+    --*this;
+    return old;
+  }
+  friend bool operator==(const ChunkedIterator& lhs, const ChunkedIterator& rhs) noexcept {
+    return lhs.chunk_ == rhs.chunk_ && lhs.pos_ == rhs.pos_;
+  }
+
+ private:
+  friend struct SegmentedIteratorTraits<ChunkedIterator>;
+
+  ChunkIterator chunk_{};
+  Value* pos_ = nullptr;
+};
+
+template <class Value>
+struct SegmentedIteratorTraits<ChunkedIterator<Value>> {
+  static constexpr bool kIsSegmented = true;
+  using SegmentIterator = typename ChunkedIterator<Value>::ChunkIterator;
+  using LocalIterator = Value*;
+
+  static SegmentIterator Segment(ChunkedIterator<Value> it) noexcept {
+    return it.chunk_;
+  }
+  static LocalIterator Local(ChunkedIterator<Value> it) noexcept {
+    return it.pos_;
+  }
+  static LocalIterator Begin(SegmentIterator chunk) noexcept {
+    return chunk->data();
+  }
+  static LocalIterator End(SegmentIterator chunk) noexcept {
+    return chunk->data() + chunk->size();
+  }
+  // Only the sentinel is empty, so the end of any non-empty chunk is the beginning of the next one.
+  static ChunkedIterator<Value> Compose(SegmentIterator chunk, LocalIterator local) noexcept {
+    if (!chunk->empty() && local == End(chunk)) {
+      ++chunk;
+      local = chunk->data();
+    }
+    return {chunk, local};
+  }
+};
+
+template <class T>
+class ChunkedSequence {
+ public:
+  using Iterator = ChunkedIterator<T>;
+  using ConstIterator = ChunkedIterator<const T>;
+
+  explicit ChunkedSequence(size_t chunk_size = 256);
+
+  void PushBack(const T& value);
+  void PushBack(T&& value);
+  // Adds the elements of chunk as one chunk of its own; an empty vector adds nothing.
+  void AppendChunk(std::vector<T> chunk);
+
+  size_t Size() const noexcept;
+  bool Empty() const noexcept;
+  size_t ChunkCount() const noexcept;
+
+  Iterator begin() noexcept;              // NOLINT
+  Iterator end() noexcept;                // NOLINT
+  ConstIterator begin() const noexcept;  // NOLINT
+  ConstIterator end() const noexcept;    // NOLINT
+
+ private:
+  std::list<std::vector<T>> chunks_;
+  size_t chunk_size_;
+  size_t size_ = 0;
+
+  std::vector<T>& OpenChunk();
+};
+
+template <class T>
+ChunkedSequence<T>::ChunkedSequence(size_t chunk_size) : chunks_(1), chunk_size_(chunk_size == 0 ? 1 : chunk_size) {
+}
+
+// Last real chunk if it has room, a new one in front of the sentinel otherwise. Its capacity is reserved up
+// front, so appending to it never moves the elements iterators point to.
+template <class T>
+std::vector<T>& ChunkedSequence<T>::OpenChunk() {
+  auto sentinel = std::prev(chunks_.end());
+  if (sentinel != chunks_.begin()) {
+    auto& last = *std::prev(sentinel);
+    if (last.size() < last.capacity()) {
+      return last;
+    }
+  }
+  auto chunk = chunks_.emplace(sentinel);
+  chunk->reserve(chunk_size_);
+  return *chunk;
+}
+
+template <class T>
+void ChunkedSequence<T>::PushBack(const T& value) {
+  OpenChunk().push_back(value);
+  ++size_;
+}
+
+template <class T>
+void ChunkedSequence<T>::PushBack(T&& value) {
+  OpenChunk().push_back(std::move(value));
+  ++size_;
+}
+
+template <class T>
+void ChunkedSequence<T>::AppendChunk(std::vector<T> chunk) {
+  if (chunk.empty()) {
+    return;
+  }
+  size_ += chunk.size();
+  chunk.shrink_to_fit();
+  chunks_.insert(std::prev(chunks_.end()), std::move(chunk));
+}
+
+template <class T>
+size_t ChunkedSequence<T>::Size() const noexcept {
+  return size_;
+}
+
+template <class T>
+bool ChunkedSequence<T>::Empty() const noexcept {
+  return size_ == 0;
+}
+
+template <class T>
+size_t ChunkedSequence<T>::ChunkCount() const noexcept {
+  return chunks_.size() - 1;
+}
+
+template <class T>
+typename ChunkedSequence<T>::Iterator ChunkedSequence<T>::begin() noexcept {
+  return {chunks_.begin(), chunks_.front().data()};
+}
+
+template <class T>
+typename ChunkedSequence<T>::Iterator ChunkedSequence<T>::end() noexcept {
+  return {std::prev(chunks_.end()), chunks_.back().data()};
+}
+
+template <class T>
+typename ChunkedSequence<T>::ConstIterator ChunkedSequence<T>::begin() const noexcept {
+  return {chunks_.begin(), chunks_.front().data()};
+}
+
+template <class T>
+typename ChunkedSequence<T>::ConstIterator ChunkedSequence<T>::end() const noexcept {
+  return {std::prev(chunks_.end()), chunks_.back().data()};
+}
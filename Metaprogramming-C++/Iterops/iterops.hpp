@@ -1,86 +1,164 @@
 #pragma once
 #include <type_traits>
 #include <iterator>
+#include <memory>
 
+// Segmented iterator protocol. An iterator into a container made of chunks (deque-like, rope, segmented vector)
+// can describe itself as a position in one chunk plus the chunk itself by specializing
+//   template <>
+//   struct SegmentedIteratorTraits<It> {
+//     static constexpr bool kIsSegmented = true;
+//     using SegmentIterator = ...;  // walks the chunks
+//     using LocalIterator = ...;    // walks inside one chunk, ideally random access
+//     static SegmentIterator Segment(It);
+//     static LocalIterator Local(It);
+//     static LocalIterator Begin(SegmentIterator);
+//     static LocalIterator End(SegmentIterator);
+//     static It Compose(SegmentIterator, LocalIterator);  // must accept End(segment)
+//   };
+// Distance, Advance, Next and Prev then cross a whole chunk in one step, so they cost O(chunks) rather than
+// O(elements) for iterators that are not random access themselves.
 template <class Iterator>
-typename std::iterator_traits<Iterator>::difference_type Distance(Iterator begin, Iterator end) {
-  if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
-                                  typename std::iterator_traits<Iterator>::iterator_category>) {
-    return end - begin;
+struct SegmentedIteratorTraits {
+  static constexpr bool kIsSegmented = false;
+};
+
+template <class Iterator>
+constexpr inline bool kIsSegmentedIteratorV = SegmentedIteratorTraits<Iterator>::kIsSegmented;
+
+template <class Iterator>
+typename std::iterator_traits<Iterator>::difference_type Distance(Iterator begin, Iterator end);
+
+template <class Iterator>
+Iterator Next(Iterator ptr, typename std::iterator_traits<Iterator>::difference_type dist = 1);
+
+template <class Iterator>
+Iterator Prev(Iterator ptr, typename std::iterator_traits<Iterator>::difference_type dist = 1);
+
+namespace detail {
+template <class Iterator>
+using DifferenceT = typename std::iterator_traits<Iterator>::difference_type;
+
+template <class Iterator>
+constexpr inline bool kIsRandomAccessV = std::is_base_of_v<std::random_access_iterator_tag,
+                                                           typename std::iterator_traits<Iterator>::iterator_category>;
+
+template <class Iterator>
+constexpr inline bool kIsBidirectionalV = std::is_base_of_v<std::bidirectional_iterator_tag,
+                                                            typename std::iterator_traits<Iterator>::iterator_category>;
+
+template <class Iterator>
+DifferenceT<Iterator> SegmentedDistance(Iterator begin, Iterator end) {
+  using Traits = SegmentedIteratorTraits<Iterator>;
+  auto segment = Traits::Segment(begin);
+  auto last = Traits::Segment(end);
+  if (segment == last) {
+    return static_cast<DifferenceT<Iterator>>(Distance(Traits::Local(begin), Traits::Local(end)));
   }
-  typename std::iterator_traits<Iterator>::difference_type n = 0;
-  while (begin != end) {
-    ++begin;
-    ++n;
+  auto n = static_cast<DifferenceT<Iterator>>(Distance(Traits::Local(begin), Traits::End(segment)));
+  for (++segment; segment != last; ++segment) {
+    n += static_cast<DifferenceT<Iterator>>(Distance(Traits::Begin(segment), Traits::End(segment)));
   }
-  return n;
+  return n + static_cast<DifferenceT<Iterator>>(Distance(Traits::Begin(last), Traits::Local(end)));
 }
 
+// Moves over whole segments while the target lies beyond the current one; stopping exactly at End(segment)
+// instead of the next segment's Begin keeps the walk from leaving the last segment.
 template <class Iterator>
-void Advance(Iterator& ptr, int dist) {
-  if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
-                                  typename std::iterator_traits<Iterator>::iterator_category>) {
-    ptr = ptr + dist;
-  } else {
-    if (dist < 0) {
-      if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag,
-                                      typename std::iterator_traits<Iterator>::iterator_category>) {
-        while (dist != 0) {
-          --ptr;
-          ++dist;
-        }
-      }
-    } else {
-      while (dist != 0) {
-        ++ptr;
-        --dist;
-      }
+Iterator SegmentedForward(Iterator ptr, DifferenceT<Iterator> dist) {
+  using Traits = SegmentedIteratorTraits<Iterator>;
+  auto segment = Traits::Segment(ptr);
+  auto local = Traits::Local(ptr);
+  while (true) {
+    auto rest = static_cast<DifferenceT<Iterator>>(Distance(local, Traits::End(segment)));
+    if (dist <= rest) {
+      return Traits::Compose(segment, Next(local, dist));
     }
+    dist -= rest;
+    ++segment;
+    local = Traits::Begin(segment);
   }
 }
 
 template <class Iterator>
-Iterator Next(Iterator ptr, int dist = 1) {
-  if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
-                                  typename std::iterator_traits<Iterator>::iterator_category>) {
-    return ptr + dist;
-  }
-  if (dist < 0) {
-    if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag,
-                                    typename std::iterator_traits<Iterator>::iterator_category>) {
-      while (dist != 0) {
-        --ptr;
-        ++dist;
-      }
+Iterator SegmentedBackward(Iterator ptr, DifferenceT<Iterator> dist) {
+  using Traits = SegmentedIteratorTraits<Iterator>;
+  auto segment = Traits::Segment(ptr);
+  auto local = Traits::Local(ptr);
+  while (true) {
+    auto before = static_cast<DifferenceT<Iterator>>(Distance(Traits::Begin(segment), local));
+    if (dist <= before) {
+      return Traits::Compose(segment, Prev(local, dist));
     }
+    dist -= before;
+    --segment;
+    local = Traits::End(segment);
+  }
+}
+
+// Moves ptr dist >= 0 elements forward.
+template <class Iterator>
+Iterator StepForward(Iterator ptr, DifferenceT<Iterator> dist) {
+  if constexpr (kIsRandomAccessV<Iterator>) {
+    return ptr + dist;
+  } else if constexpr (kIsSegmentedIteratorV<Iterator>) {
+    return SegmentedForward(ptr, dist);
   } else {
-    while (dist != 0) {
+    for (; dist != 0; --dist) {
       ++ptr;
-      --dist;
     }
+    return ptr;
   }
-  return ptr;
 }
 
+// Moves ptr dist >= 0 elements backward; iterators that cannot go back stay where they are.
 template <class Iterator>
-Iterator Prev(Iterator ptr, int dist = 1) {
-  if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
-                                  typename std::iterator_traits<Iterator>::iterator_category>) {
+Iterator StepBackward(Iterator ptr, DifferenceT<Iterator> dist) {
+  if constexpr (kIsRandomAccessV<Iterator>) {
     return ptr - dist;
-  }
-  if (dist < 0) {
-    while (dist != 0) {
-      ++ptr;
-      ++dist;
+  } else if constexpr (kIsSegmentedIteratorV<Iterator> && kIsBidirectionalV<Iterator>) {
+    return SegmentedBackward(ptr, dist);
+  } else if constexpr (kIsBidirectionalV<Iterator>) {
+    for (; dist != 0; --dist) {
+      --ptr;
     }
+    return ptr;
+  } else {
+    return ptr;
+  }
+}
+}  // namespace detail
+
+// Contiguous iterators are measured on the raw addresses, which skips any checking a debug iterator does.
+template <class Iterator>
+typename std::iterator_traits<Iterator>::difference_type Distance(Iterator begin, Iterator end) {
+  if constexpr (std::contiguous_iterator<Iterator>) {
+    return std::to_address(end) - std::to_address(begin);
+  } else if constexpr (detail::kIsRandomAccessV<Iterator>) {
+    return end - begin;
+  } else if constexpr (kIsSegmentedIteratorV<Iterator>) {
+    return detail::SegmentedDistance(begin, end);
   } else {
-    if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag,
-                                    typename std::iterator_traits<Iterator>::iterator_category>) {
-      while (dist != 0) {
-        --ptr;
-        --dist;
-      }
+    typename std::iterator_traits<Iterator>::difference_type n = 0;
+    while (begin != end) {
+      ++begin;
+      ++n;
     }
+    return n;
   }
-  return ptr;
+}
+
+template <class Iterator>
+void Advance(Iterator& ptr, typename std::iterator_traits<Iterator>::difference_type dist) {
+  ptr = dist < 0 ? detail::StepBackward(ptr, -dist) : detail::StepForward(ptr, dist);
+}
+
+template <class Iterator>
+Iterator Next(Iterator ptr, typename std::iterator_traits<Iterator>::difference_type dist) {
+  return dist < 0 ? detail::StepBackward(ptr, -dist) : detail::StepForward(ptr, dist);
+}
+
+template <class Iterator>
+Iterator Prev(Iterator ptr, typename std::iterator_traits<Iterator>::difference_type dist) {
+  return dist < 0 ? detail::StepForward(ptr, -dist) : detail::StepBackward(ptr, dist);
 }
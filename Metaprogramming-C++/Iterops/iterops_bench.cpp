@@ -0,0 +1,89 @@
+// Distance, Next, Prev and Advance on a ChunkedSequence, whose bidirectional iterators are segmented, against
+// std::distance and std::next, which step one element at a time. Every result is checked against the
+// element-by-element answer before anything is timed.
+//
+//   g++ -std=c++20 -O2 iterops_bench.cpp -o iterops_bench && ./iterops_bench [chunks]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+#include "chunked_sequence.hpp"
+
+constexpr int kQueries = 200;
+
+template <class F>
+double Millis(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Uneven chunk sizes, as a rope built from concatenated pieces would have.
+ChunkedSequence<int> MakeRope(size_t chunks) {
+  ChunkedSequence<int> rope;
+  int value = 0;
+  for (size_t c = 0; c < chunks; ++c) {
+    std::vector<int> chunk(100 + c * 37 % 500);
+    for (auto& x : chunk) {
+      x = value++;
+    }
+    rope.AppendChunk(std::move(chunk));
+  }
+  return rope;
+}
+
+ptrdiff_t Offset(int query, ptrdiff_t size) {
+  return static_cast<ptrdiff_t>(static_cast<unsigned>(query) * 2654435761u % static_cast<size_t>(size + 1));
+}
+
+bool Check(const ChunkedSequence<int>& rope) {
+  auto begin = rope.begin();
+  auto end = rope.end();
+  auto size = static_cast<ptrdiff_t>(rope.Size());
+  if (Distance(begin, end) != size || Next(begin, size) != end || Prev(end, size) != begin) {
+    return false;
+  }
+  for (int q = 0; q < kQueries; ++q) {
+    auto a = Offset(q, size);
+    auto b = Offset(q + kQueries, size);
+    auto it = Next(begin, a);
+    if (it != std::next(begin, a) || (a < size && *it != a) || Prev(end, size - a) != it) {
+      return false;
+    }
+    Advance(it, b - a);
+    if (it != std::next(begin, b) || Distance(Next(begin, std::min(a, b)), Next(begin, std::max(a, b))) !=
+                                          std::max(a, b) - std::min(a, b)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  size_t chunks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+  auto rope = MakeRope(chunks);
+  auto size = static_cast<ptrdiff_t>(rope.Size());
+  std::printf("%zu chunks, %zu elements: %s\n", rope.ChunkCount(), rope.Size(),
+              Check(rope) ? "results match std::next/std::distance" : "MISMATCH");
+
+  auto begin = rope.begin();
+  auto end = rope.end();
+  ptrdiff_t checksum = 0;
+  auto segmented = Millis([&] {
+    for (int q = 0; q < kQueries; ++q) {
+      auto it = Next(begin, Offset(q, size));
+      checksum += Distance(it, end) + *Prev(end, 1);
+    }
+  });
+  auto stepping = Millis([&] {
+    for (int q = 0; q < kQueries; ++q) {
+      auto it = std::next(begin, Offset(q, size));
+      checksum -= std::distance(it, end) + *std::prev(end, 1);
+    }
+  });
+  std::printf("%d x (Next + Distance + Prev): segmented %8.2f ms, element by element %8.2f ms (%.0fx)%s\n",
+              kQueries, segmented, stepping, stepping / segmented, checksum == 0 ? "" : "  MISMATCH");
+}
@@ -3,6 +3,11 @@
 #include <type_traits>
 #include <exception>
 #include <iostream>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
 
 class BadOptionalAccess : public std::runtime_error {
  public:
@@ -10,187 +15,282 @@ class BadOptionalAccess : public std::runtime_error {
   }
 };
 
+// Niche hook: a type with a value that never occurs as a real one can lend it to Optional to mean "empty",
+// which makes Optional<T> exactly sizeof(T). Specialize it with
+//   static constexpr bool kHasNiche = true;
+//   static constexpr T Empty() noexcept;                 // the spare value
+//   static constexpr bool IsEmpty(const T&) noexcept;    // checks for it
+// or derive from one of the helpers below, e.g.
+//   template <>
+//   struct OptionalNiche<uint32_t> : ValueNiche<uint32_t, UINT32_MAX> {};
+// T must be trivially destructible. A value equal to the spare one is indistinguishable from an empty Optional.
 template <class T>
-using As = std::aligned_storage_t<sizeof(T), alignof(T)>;
+struct OptionalNiche {
+  static constexpr bool kHasNiche = false;
+};
+
+// The spare value is kEmpty, e.g. the maximum of an integer type or an invalid enumerator.
+template <class T, T kEmpty>
+struct ValueNiche {
+  static constexpr bool kHasNiche = true;
+
+  static constexpr T Empty() noexcept {
+    return kEmpty;
+  }
+  static constexpr bool IsEmpty(const T& value) noexcept {
+    return value == kEmpty;
+  }
+};
+
+template <class T>
+struct NullNiche : ValueNiche<T, nullptr> {};
+
+// A signaling NaN with a fixed payload. Arithmetic only ever produces quiet NaNs, so it can appear only if
+// written on purpose.
+template <class T>
+struct NanNiche {
+  static_assert(std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+  using Bits = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+  static constexpr bool kHasNiche = true;
+  static constexpr Bits kPattern = sizeof(T) == 8 ? Bits(0x7ff0dead0000beefULL) : Bits(0x7f80beefU);
+
+  static constexpr T Empty() noexcept {
+    return std::bit_cast<T>(kPattern);
+  }
+  static constexpr bool IsEmpty(const T& value) noexcept {
+    return std::bit_cast<Bits>(value) == kPattern;
+  }
+};
+
+namespace detail {
+struct Disengaged {};
+struct NoFlag {};
+}  // namespace detail
 
+// The value lives in a union, so every special member of Optional<T> is trivial whenever the matching one of T
+// is: an Optional of a trivially copyable type is trivially copyable itself and containers relocate it with
+// memcpy. Non-trivial types get the hand-written versions below, which assign in place when both sides hold a
+// value. Construction, access and assignment are constexpr.
 template <class T>
 class Optional {
-  As<T> storage_;
-  bool alive_ = false;
+  using Niche = OptionalNiche<T>;
+  static constexpr bool kHasNiche = Niche::kHasNiche;
+  static_assert(!kHasNiche || std::is_trivially_destructible_v<T>, "niche types are overwritten without a destructor");
+
+  static constexpr bool kTrivialCopy =
+      std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_assignable_v<T> &&
+      std::is_trivially_destructible_v<T>;
+  static constexpr bool kTrivialMove =
+      std::is_trivially_move_constructible_v<T> && std::is_trivially_move_assignable_v<T> &&
+      std::is_trivially_destructible_v<T>;
+
+  union {
+    detail::Disengaged empty_;
+    T value_;
+  };
+  [[no_unique_address]] std::conditional_t<kHasNiche, detail::NoFlag, bool> alive_{};
 
  public:
-  Optional() = default;
-  Optional(const Optional&);  // NOLINT
-  Optional(Optional&&);       // NOLINT
-  Optional(const T&);         // NOLINT
-  Optional(T&&);              // NOLINT
-  ~Optional();
-  Optional& operator=(const Optional&);
-  Optional& operator=(Optional&&);
-  Optional& operator=(const T&);
-  Optional& operator=(T&&);
-  bool HasValue() const;
-  explicit operator bool() const;
-  T& Value();
-  const T& Value() const;
-  const T& operator*() const;
-  T& operator*();
+  constexpr Optional() noexcept;
+  Optional(const Optional&) requires std::is_trivially_copy_constructible_v<T> = default;
+  constexpr Optional(const Optional&);  // NOLINT
+  Optional(Optional&&) requires std::is_trivially_move_constructible_v<T> = default;
+  constexpr Optional(Optional&&) noexcept(std::is_nothrow_move_constructible_v<T>);  // NOLINT
+  constexpr Optional(const T&);                                                      // NOLINT
+  constexpr Optional(T&&);                                                           // NOLINT
+  ~Optional() requires std::is_trivially_destructible_v<T> = default;
+  constexpr ~Optional();
+  Optional& operator=(const Optional&) requires kTrivialCopy = default;
+  constexpr Optional& operator=(const Optional&);
+  Optional& operator=(Optional&&) requires kTrivialMove = default;
+  constexpr Optional& operator=(Optional&&);
+  constexpr Optional& operator=(const T&);
+  constexpr Optional& operator=(T&&);
+  constexpr bool HasValue() const;
+  constexpr explicit operator bool() const;
+  constexpr T& Value();
+  constexpr const T& Value() const;
+  constexpr const T& operator*() const;
+  constexpr T& operator*();
   template <class... Args>
-  T& Emplace(Args&&... args) {
-    if (alive_) {
-      reinterpret_cast<T*>(&storage_)->~T();
-    }
-    alive_ = true;
-    new (&storage_) T(std::forward<Args>(args)...);
-    return *(reinterpret_cast<T*>(&storage_));
+  constexpr T& Emplace(Args&&... args) {
+    Reset();
+    std::construct_at(&value_, std::forward<Args>(args)...);
+    MarkAlive();
+    return value_;
   }
-  void Reset();
-  void Swap(Optional&);
+  constexpr void Reset();
+  constexpr void Swap(Optional&);
+
+ private:
+  constexpr void MarkAlive() noexcept;
+  constexpr void MarkEmpty() noexcept;
 };
 
+// With a niche the flag is the value itself: the object is alive unless it holds the spare value.
 template <class T>
-bool Optional<T>::HasValue() const {
-  return alive_;
+constexpr void Optional<T>::MarkAlive() noexcept {
+  if constexpr (!kHasNiche) {
+    alive_ = true;
+  }
 }
 
 template <class T>
-Optional<T>::Optional(const Optional<T>& other) {
-  if (other.alive_) {
-    alive_ = true;
-    new (&storage_) T(*reinterpret_cast<const T*>(&(other.storage_)));
+constexpr void Optional<T>::MarkEmpty() noexcept {
+  if constexpr (kHasNiche) {
+    std::construct_at(&value_, Niche::Empty());
+  } else {
+    alive_ = false;
   }
 }
 
 template <class T>
-Optional<T>::Optional(Optional<T>&& other) {
-  if (other.alive_) {
-    alive_ = true;
-    new (&storage_) T(std::move(*reinterpret_cast<T*>(&(other.storage_))));
+constexpr bool Optional<T>::HasValue() const {
+  if constexpr (kHasNiche) {
+    return !Niche::IsEmpty(value_);
+  } else {
+    return alive_;
   }
 }
 
 template <class T>
-Optional<T>::Optional(const T& value) {
-  alive_ = true;
-  new (&storage_) T(value);
+constexpr Optional<T>::Optional() noexcept : empty_() {
+  MarkEmpty();
 }
 
 template <class T>
-Optional<T>::Optional(T&& value) {
-  alive_ = true;
-  new (&storage_) T(std::move(value));
+constexpr Optional<T>::Optional(const Optional<T>& other) : Optional() {
+  if (other.HasValue()) {
+    std::construct_at(&value_, other.value_);
+    MarkAlive();
+  }
 }
 
 template <class T>
-Optional<T>::~Optional() {
-  if (alive_) {
-    reinterpret_cast<T*>(&storage_)->~T();
+constexpr Optional<T>::Optional(Optional<T>&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : Optional() {
+  if (other.HasValue()) {
+    std::construct_at(&value_, std::move(other.value_));
+    MarkAlive();
   }
 }
 
 template <class T>
-Optional<T>& Optional<T>::operator=(const Optional<T>& other) {
-  if (alive_) {
-    reinterpret_cast<T*>(&storage_)->~T();
+constexpr Optional<T>::Optional(const T& value) : value_(value) {
+  MarkAlive();
+}
+
+template <class T>
+constexpr Optional<T>::Optional(T&& value) : value_(std::move(value)) {
+  MarkAlive();
+}
+
+template <class T>
+constexpr Optional<T>::~Optional() {
+  if (HasValue()) {
+    std::destroy_at(&value_);
   }
-  if (other.alive_) {
-    alive_ = true;
-    new (&storage_) T(*reinterpret_cast<const T*>(&(other.storage_)));
+}
+
+template <class T>
+constexpr Optional<T>& Optional<T>::operator=(const Optional<T>& other) {
+  if (!other.HasValue()) {
+    Reset();
+  } else if (HasValue()) {
+    value_ = other.value_;
   } else {
-    alive_ = false;
+    std::construct_at(&value_, other.value_);
+    MarkAlive();
   }
   return *this;
 }
 
 template <class T>
-Optional<T>& Optional<T>::operator=(Optional<T>&& other) {
-  if (alive_) {
-    reinterpret_cast<T*>(&storage_)->~T();
-  }
-  if (other.alive_) {
-    alive_ = true;
-    new (&storage_) T(std::move(*reinterpret_cast<T*>(&(other.storage_))));
+constexpr Optional<T>& Optional<T>::operator=(Optional<T>&& other) {
+  if (!other.HasValue()) {
+    Reset();
+  } else if (HasValue()) {
+    value_ = std::move(other.value_);
   } else {
-    alive_ = false;
+    std::construct_at(&value_, std::move(other.value_));
+    MarkAlive();
   }
   return *this;
 }
 
 template <class T>
-Optional<T>& Optional<T>::operator=(const T& value) {
-  if (alive_) {
-    reinterpret_cast<T*>(&storage_)->~T();
+constexpr Optional<T>& Optional<T>::operator=(const T& value) {
+  if (HasValue()) {
+    value_ = value;
+  } else {
+    std::construct_at(&value_, value);
+    MarkAlive();
   }
-  new (&storage_) T(value);
-  alive_ = true;
   return *this;
 }
 
 template <class T>
-Optional<T>& Optional<T>::operator=(T&& value) {
-  if (alive_) {
-    reinterpret_cast<T*>(&storage_)->~T();
+constexpr Optional<T>& Optional<T>::operator=(T&& value) {
+  if (HasValue()) {
+    value_ = std::move(value);
+  } else {
+    std::construct_at(&value_, std::move(value));
+    MarkAlive();
   }
-  new (&storage_) T(std::move(value));
-  alive_ = true;
   return *this;
 }
 
 template <class T>
-Optional<T>::operator bool() const {
-  return alive_;
+constexpr Optional<T>::operator bool() const {
+  return HasValue();
 }
 
 template <class T>
-T& Optional<T>::Value() {
-  if (alive_) {
-    return *reinterpret_cast<T*>(&storage_);
+constexpr T& Optional<T>::Value() {
+  if (HasValue()) {
+    return value_;
   }
   throw BadOptionalAccess{};
 }
 
 template <class T>
-const T& Optional<T>::Value() const {
-  if (alive_) {
-    return *reinterpret_cast<const T*>(&storage_);
+constexpr const T& Optional<T>::Value() const {
+  if (HasValue()) {
+    return value_;
   }
   throw BadOptionalAccess{};
 }
 
 template <class T>
-void Optional<T>::Reset() {
-  if (alive_) {
-    reinterpret_cast<T*>(&storage_)->~T();
+constexpr void Optional<T>::Reset() {
+  if (HasValue()) {
+    std::destroy_at(&value_);
+    MarkEmpty();
   }
-  alive_ = false;
 }
 
 template <class T>
-T& Optional<T>::operator*() {
-  return *reinterpret_cast<T*>(&storage_);
+constexpr T& Optional<T>::operator*() {
+  return value_;
 }
 
 template <class T>
-const T& Optional<T>::operator*() const {
-  return *reinterpret_cast<const T*>(&storage_);
+constexpr const T& Optional<T>::operator*() const {
+  return value_;
 }
 
 template <class T>
-void Optional<T>::Swap(Optional<T>& other) {
-  if (other.alive_ && alive_) {
-    std::swap(*reinterpret_cast<T*>(&storage_), *reinterpret_cast<T*>(&(other.storage_)));
+constexpr void Optional<T>::Swap(Optional<T>& other) {
+  if (other.HasValue() && HasValue()) {
+    std::swap(value_, other.value_);
     return;
   }
-  if (!(other.alive_) && !(alive_)) {
+  if (!(other.HasValue()) && !(HasValue())) {
     return;
   }
-  if (other.alive_) {
-    alive_ = true;
-    other.alive_ = false;
-    new (&storage_) T(std::move(*reinterpret_cast<T*>(&(other.storage_))));
-  } else {
-    other.alive_ = true;
-    alive_ = false;
-    new (&(other.storage_)) T(std::move(*reinterpret_cast<T*>(&storage_)));
-  }
-}
\ No newline at end of file
+  auto& from = HasValue() ? *this : other;
+  auto& to = HasValue() ? other : *this;
+  std::construct_at(&to.value_, std::move(from.value_));
+  to.MarkAlive();
+  from.Reset();
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "optional.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define OPTIONAL_HAS_AVX2_KERNELS
+#endif
+
+// Optional<T&>-style view of a slot: a pointer to the value, or null when there is none.
+template <class T>
+class OptionalRef {
+  T* ptr_;
+
+ public:
+  constexpr OptionalRef() noexcept : ptr_(nullptr) {
+  }
+  constexpr explicit OptionalRef(T* ptr) noexcept : ptr_(ptr) {
+  }
+  constexpr bool HasValue() const noexcept {
+    return ptr_ != nullptr;
+  }
+  constexpr explicit operator bool() const noexcept {
+    return ptr_ != nullptr;
+  }
+  constexpr T& Value() const {
+    if (ptr_) {
+      return *ptr_;
+    }
+    throw BadOptionalAccess{};
+  }
+  constexpr T& operator*() const noexcept {
+    return *ptr_;
+  }
+};
+
+namespace detail {
+inline size_t CountBitsScalar(const uint64_t* words, size_t n) noexcept {
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    count += static_cast<size_t>(std::popcount(words[i]));
+  }
+  return count;
+}
+
+inline size_t FirstNonZeroWordScalar(const uint64_t* words, size_t from, size_t n) noexcept {
+  while (from < n && words[from] == 0) {
+    ++from;
+  }
+  return from;
+}
+
+#ifdef OPTIONAL_HAS_AVX2_KERNELS
+// Counts the bits of each byte with two 16-entry table lookups (one per nibble) and sums the bytes of every
+// 64-bit lane with sad against zero.
+__attribute__((target("avx2"))) inline size_t CountBitsAvx2(const uint64_t* words, size_t n) noexcept {
+  const auto table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,  //
+                                      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const auto low_mask = _mm256_set1_epi8(0x0F);
+  auto total = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    auto low = _mm256_shuffle_epi8(table, _mm256_and_si256(chunk, low_mask));
+    auto high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low_mask));
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+  }
+  alignas(32) uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+  return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + CountBitsScalar(words + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline size_t FirstNonZeroWordAvx2(const uint64_t* words, size_t from,
+                                                                   size_t n) noexcept {
+  for (; from + 4 <= n; from += 4) {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + from));
+    if (!_mm256_testz_si256(chunk, chunk)) {
+      break;
+    }
+  }
+  return FirstNonZeroWordScalar(words, from, n);
+}
+#endif
+
+inline size_t CountBits(const uint64_t* words, size_t n) noexcept {
+#ifdef OPTIONAL_HAS_AVX2_KERNELS
+  static const bool kHasAvx2 = __builtin_cpu_supports("avx2");
+  if (kHasAvx2) {
+    return CountBitsAvx2(words, n);
+  }
+#endif
+  return CountBitsScalar(words, n);
+}
+
+// Index of the first non-zero word in [from, n), or n.
+inline size_t FirstNonZeroWord(const uint64_t* words, size_t from, size_t n) noexcept {
+#ifdef OPTIONAL_HAS_AVX2_KERNELS
+  static const bool kHasAvx2 = __builtin_cpu_supports("avx2");
+  if (kHasAvx2) {
+    return FirstNonZeroWordAvx2(words, from, n);
+  }
+#endif
+  return FirstNonZeroWordScalar(words, from, n);
+}
+}  // namespace detail
+
+// Fixed number of optional slots stored as columns: the values in one uninitialized buffer of T and the
+// presence flags in a separate bitmap, one bit per slot. Both are allocated once by the constructor; setting
+// and clearing slots never allocates. Values are created with construct_at and destroyed explicitly, exactly
+// like in Optional, so a slot holds a live T if and only if its bit is set.
+template <class T>
+class OptionalArray {
+  static constexpr size_t kWordBits = 64;
+
+  T* data_;
+  uint64_t* bits_;
+  size_t size_;
+
+ public:
+  explicit OptionalArray(size_t size = 0);
+  OptionalArray(const OptionalArray&);
+  OptionalArray(OptionalArray&&) noexcept;
+  OptionalArray& operator=(const OptionalArray&);
+  OptionalArray& operator=(OptionalArray&&) noexcept;
+  ~OptionalArray();
+
+  size_t Size() const noexcept;
+  bool HasValue(size_t) const noexcept;
+  OptionalRef<T> operator[](size_t) noexcept;
+  OptionalRef<const T> operator[](size_t) const noexcept;
+  T* Data() noexcept;
+  const T* Data() const noexcept;
+  const uint64_t* Bitmap() const noexcept;
+
+  template <class... Args>
+  T& Emplace(size_t, Args&&... args);
+  void Reset(size_t) noexcept;
+  void Clear() noexcept;
+  void Swap(OptionalArray&) noexcept;
+
+  size_t CountPresent() const noexcept;
+  size_t NextPresent(size_t) const noexcept;
+
+ private:
+  static size_t Words(size_t size) noexcept;
+};
+
+template <class T>
+size_t OptionalArray<T>::Words(size_t size) noexcept {
+  return (size + kWordBits - 1) / kWordBits;
+}
+
+template <class T>
+OptionalArray<T>::OptionalArray(size_t size) : data_(nullptr), bits_(nullptr), size_(0) {
+  if (size == 0) {
+    return;
+  }
+  data_ = std::allocator<T>().allocate(size);
+  try {
+    bits_ = std::allocator<uint64_t>().allocate(Words(size));
+  } catch (...) {
+    std::allocator<T>().deallocate(data_, size);
+    throw;
+  }
+  std::uninitialized_fill_n(bits_, Words(size), uint64_t{0});
+  size_ = size;
+}
+
+template <class T>
+OptionalArray<T>::OptionalArray(const OptionalArray& other) : OptionalArray(other.size_) {
+  for (auto idx = other.NextPresent(0); idx < other.size_; idx = other.NextPresent(idx + 1)) {
+    Emplace(idx, other.data_[idx]);
+  }
+}
+
+template <class T>
+OptionalArray<T>::OptionalArray(OptionalArray&& other) noexcept
+    : data_(other.data_), bits_(other.bits_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.bits_ = nullptr;
+  other.size_ = 0;
+}
+
+template <class T>
+OptionalArray<T>& OptionalArray<T>::operator=(const OptionalArray& other) {
+  if (this != &other) {
+    OptionalArray tmp(other);
+    Swap(tmp);
+  }
+  return *this;
+}
+
+template <class T>
+OptionalArray<T>& OptionalArray<T>::operator=(OptionalArray&& other) noexcept {
+  if (this != &other) {
+    OptionalArray tmp(std::move(other));
+    Swap(tmp);
+  }
+  return *this;
+}
+
+template <class T>
+OptionalArray<T>::~OptionalArray() {
+  Clear();
+  if (data_) {
+    std::allocator<T>().deallocate(data_, size_);
+    std::allocator<uint64_t>().deallocate(bits_, Words(size_));
+  }
+}
+
+template <class T>
+size_t OptionalArray<T>::Size() const noexcept {
+  return size_;
+}
+
+template <class T>
+bool OptionalArray<T>::HasValue(size_t idx) const noexcept {
+  return (bits_[idx / kWordBits] >> (idx % kWordBits)) & 1;
+}
+
+template <class T>
+OptionalRef<T> OptionalArray<T>::operator[](size_t idx) noexcept {
+  return HasValue(idx) ? OptionalRef<T>(data_ + idx) : OptionalRef<T>();
+}
+
+template <class T>
+OptionalRef<const T> OptionalArray<T>::operator[](size_t idx) const noexcept {
+  return HasValue(idx) ? OptionalRef<const T>(data_ + idx) : OptionalRef<const T>();
+}
+
+// Only the slots whose bit is set hold live objects.
+template <class T>
+T* OptionalArray<T>::Data() noexcept {
+  return data_;
+}
+
+template <class T>
+const T* OptionalArray<T>::Data() const noexcept {
+  return data_;
+}
+
+// Bit i % 64 of word i / 64 is set if slot i holds a value; bits past Size() are zero.
+template <class T>
+const uint64_t* OptionalArray<T>::Bitmap() const noexcept {
+  return bits_;
+}
+
+template <class T>
+template <class... Args>
+T& OptionalArray<T>::Emplace(size_t idx, Args&&... args) {
+  Reset(idx);
+  std::construct_at(data_ + idx, std::forward<Args>(args)...);
+  bits_[idx / kWordBits] |= uint64_t{1} << (idx % kWordBits);
+  return data_[idx];
+}
+
+template <class T>
+void OptionalArray<T>::Reset(size_t idx) noexcept {
+  if (HasValue(idx)) {
+    std::destroy_at(data_ + idx);
+    bits_[idx / kWordBits] &= ~(uint64_t{1} << (idx % kWordBits));
+  }
+}
+
+template <class T>
+void OptionalArray<T>::Clear() noexcept {
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (auto idx = NextPresent(0); idx < size_; idx = NextPresent(idx + 1)) {
+      std::destroy_at(data_ + idx);
+    }
+  }
+  std::fill_n(bits_, Words(size_), uint64_t{0});
+}
+
+template <class T>
+void OptionalArray<T>::Swap(OptionalArray& other) noexcept {
+  std::swap(data_, other.data_);
+  std::swap(bits_, other.bits_);
+  std::swap(size_, other.size_);
+}
+
+template <class T>
+size_t OptionalArray<T>::CountPresent() const noexcept {
+  return detail::CountBits(bits_, Words(size_));
+}
+
+// Index of the first slot at or after from that holds a value, or Size() if there is none.
+template <class T>
+size_t OptionalArray<T>::NextPresent(size_t from) const noexcept {
+  if (from >= size_) {
+    return size_;
+  }
+  auto word = from / kWordBits;
+  auto rest = bits_[word] >> (from % kWordBits);
+  if (rest != 0) {
+    return from + static_cast<size_t>(std::countr_zero(rest));
+  }
+  word = detail::FirstNonZeroWord(bits_, word + 1, Words(size_));
+  if (word == Words(size_)) {
+    return size_;
+  }
+  return word * kWordBits + static_cast<size_t>(std::countr_zero(bits_[word]));
+}
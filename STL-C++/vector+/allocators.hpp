@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+// Bump-pointer arena: allocation is a pointer increment, deallocation is a no-op and all memory is returned
+// at once by Release() or the destructor. Chunks grow geometrically so large requests stay amortized.
+class Arena {
+  struct Chunk {
+    Chunk* prev;
+    size_t size;
+  };
+
+  Chunk* head_ = nullptr;
+  std::byte* cur_ = nullptr;
+  std::byte* end_ = nullptr;
+  size_t next_chunk_size_;
+
+ public:
+  static constexpr size_t kDefaultChunkSize = 4096;
+
+  explicit Arena(size_t chunk_size = kDefaultChunkSize) noexcept : next_chunk_size_(chunk_size) {
+  }
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  ~Arena() {
+    Release();
+  }
+
+  // The end of a chunk need not be aligned, so the padding is checked against the room left before the
+  // aligned pointer is formed.
+  void* Allocate(size_t bytes, size_t align) {
+    auto room = static_cast<size_t>(end_ - cur_);
+    auto padding = Padding(cur_, align);
+    if (cur_ == nullptr || padding > room || room - padding < bytes) {
+      NewChunk(bytes + align);
+      padding = Padding(cur_, align);
+    }
+    auto aligned = cur_ + padding;
+    cur_ = aligned + bytes;
+    return aligned;
+  }
+
+  void Release() noexcept {
+    while (head_) {
+      auto prev = head_->prev;
+      ::operator delete(head_, sizeof(Chunk) + head_->size);
+      head_ = prev;
+    }
+    cur_ = nullptr;
+    end_ = nullptr;
+  }
+
+ private:
+  // Bytes from ptr up to the next multiple of align.
+  static size_t Padding(std::byte* ptr, size_t align) noexcept {
+    auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+    return (align - addr % align) % align;
+  }
+
+  void NewChunk(size_t min_size) {
+    auto size = next_chunk_size_ < min_size ? min_size : next_chunk_size_;
+    auto chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+    chunk->prev = head_;
+    chunk->size = size;
+    head_ = chunk;
+    cur_ = reinterpret_cast<std::byte*>(chunk + 1);
+    end_ = cur_ + size;
+    next_chunk_size_ = size * 2;
+  }
+};
+
+// Allocator over an Arena. It propagates with the container, so moving or swapping vectors that live in
+// different arenas stays O(1).
+template <class T>
+class ArenaAllocator {
+  Arena* arena_;
+
+  template <class U>
+  friend class ArenaAllocator;
+
+ public:
+  using value_type = T;  // NOLINT
+  using propagate_on_container_copy_assignment = std::true_type;  // NOLINT
+  using propagate_on_container_move_assignment = std::true_type;  // NOLINT
+  using propagate_on_container_swap = std::true_type;             // NOLINT
+  using is_always_equal = std::false_type;                        // NOLINT
+
+  explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {
+  }
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) {  // NOLINT
+  }
+
+  T* allocate(size_t n) {  // NOLINT
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, size_t) noexcept {  // NOLINT
+  }
+
+  template <class U>
+  bool operator==(const ArenaAllocator<U>& other) const noexcept {
+    return arena_ == other.arena_;
+  }
+  template <class U>
+  bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+    return arena_ != other.arena_;
+  }
+};
+
+// Adapter from std::pmr::memory_resource (pools, monotonic buffers, huge-page resources) to a plain
+// allocator. Unlike std::pmr::polymorphic_allocator it propagates with the container.
+template <class T>
+class ResourceAllocator {
+  std::pmr::memory_resource* resource_;
+
+  template <class U>
+  friend class ResourceAllocator;
+
+ public:
+  using value_type = T;  // NOLINT
+  using propagate_on_container_copy_assignment = std::true_type;  // NOLINT
+  using propagate_on_container_move_assignment = std::true_type;  // NOLINT
+  using propagate_on_container_swap = std::true_type;             // NOLINT
+  using is_always_equal = std::false_type;                        // NOLINT
+
+  ResourceAllocator() noexcept : resource_(std::pmr::get_default_resource()) {
+  }
+  explicit ResourceAllocator(std::pmr::memory_resource* resource) noexcept : resource_(resource) {
+  }
+  template <class U>
+  ResourceAllocator(const ResourceAllocator<U>& other) noexcept : resource_(other.resource_) {  // NOLINT
+  }
+
+  T* allocate(size_t n) {  // NOLINT
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* ptr, size_t n) noexcept {  // NOLINT
+    resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+  }
+
+  std::pmr::memory_resource* Resource() const noexcept {
+    return resource_;
+  }
+
+  template <class U>
+  bool operator==(const ResourceAllocator<U>& other) const noexcept {
+    return resource_ == other.resource_ || resource_->is_equal(*other.resource_);
+  }
+  template <class U>
+  bool operator!=(const ResourceAllocator<U>& other) const noexcept {
+    return !(*this == other);
+  }
+};
@@ -0,0 +1,103 @@
+// Vector over ArenaAllocator against std::allocator on many short-lived vectors of mixed element types, after
+// a check that Arena hands out aligned, non-overlapping blocks for mixed sizes and alignments. Run it under
+// -fsanitize=address to have every block checked against the bounds of its chunk as well.
+//
+//   g++ -std=c++20 -O2 allocators_bench.cpp -o allocators_bench && ./allocators_bench
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "allocators.hpp"
+#include "vector.hpp"
+
+constexpr size_t kRounds = 2000;
+constexpr size_t kVectors = 256;
+
+struct Block {
+  uintptr_t begin;
+  uintptr_t end;
+};
+
+// Fills each block, so a block that runs past its chunk writes out of bounds.
+bool Check() {
+  std::vector<Block> blocks;
+  auto take = [&](Arena& arena, size_t bytes, size_t align) {
+    auto ptr = arena.Allocate(bytes, align);
+    std::memset(ptr, 0xab, bytes);
+    auto addr = reinterpret_cast<uintptr_t>(ptr);
+    blocks.push_back({addr, addr + bytes});
+    return addr % align == 0;
+  };
+  bool aligned = true;
+  {
+    // A char block that leaves the chunk ending off an 8-byte boundary, then an aligned one that no longer fits.
+    Arena arena;
+    aligned &= take(arena, 5000, 1);
+    aligned &= take(arena, 1, 1);
+    aligned &= take(arena, 64, 8);
+  }
+  Arena arena(64);
+  uint64_t state = 7;
+  for (int i = 0; i < 100000; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    aligned &= take(arena, 1 + (state >> 33 & 255), size_t{1} << (state >> 60 & 6));
+  }
+  std::sort(blocks.begin() + 3, blocks.end(), [](Block lhs, Block rhs) { return lhs.begin < rhs.begin; });
+  for (size_t i = 4; i < blocks.size(); ++i) {
+    if (blocks[i].begin < blocks[i - 1].end) {
+      return false;
+    }
+  }
+  return aligned;
+}
+
+template <class T, class Make>
+uint64_t Fill(Make make, uint64_t& state) {
+  uint64_t checksum = 0;
+  for (size_t v = 0; v < kVectors; ++v) {
+    auto vector = make(T{});
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    auto n = state >> 33 & 63;
+    for (size_t i = 0; i < n; ++i) {
+      vector.PushBack(static_cast<T>(i));
+    }
+    checksum += vector.Size();
+  }
+  return checksum;
+}
+
+template <class F>
+double Millis(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+  std::printf("Arena blocks: %s\n", Check() ? "aligned and disjoint" : "OVERLAP OR MISALIGNED");
+
+  uint64_t checksum = 0;
+  auto standard = Millis([&] {
+    uint64_t state = 1;
+    for (size_t r = 0; r < kRounds; ++r) {
+      checksum += Fill<char>([](char) { return Vector<char>(); }, state);
+      checksum += Fill<double>([](double) { return Vector<double>(); }, state);
+    }
+  });
+  auto arena = Millis([&] {
+    uint64_t state = 1;
+    for (size_t r = 0; r < kRounds; ++r) {
+      Arena memory;
+      checksum -= Fill<char>([&](char) { return Vector<char, ArenaAllocator<char>>(ArenaAllocator<char>(memory)); },
+                             state);
+      checksum -= Fill<double>(
+          [&](double) { return Vector<double, ArenaAllocator<double>>(ArenaAllocator<double>(memory)); }, state);
+    }
+  });
+  std::printf("%zu rounds of %zu char and %zu double vectors: std::allocator %.1f ms, ArenaAllocator %.1f ms%s\n",
+              kRounds, kVectors, kVectors, standard, arena, checksum == 0 ? "" : "  MISMATCH");
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Append-only vector that any number of threads may push into at once. Elements live in segments that are
+// never moved: segment k holds kFirstSegmentSize << k elements, so index i is found in O(1) from the position
+// of the highest set bit of i / kFirstSegmentSize + 1, and references stay valid for the lifetime of the vector.
+// PushBack reserves its slot with a single fetch_add; a missing segment is allocated by whichever thread needs
+// it first and published with compare-and-swap.
+//
+// Size() counts reserved slots, so an element may be read by another thread only once the PushBack that wrote
+// it has returned and that fact has been communicated (e.g. by joining the writer or through the returned
+// reference). Clear and destruction must not overlap with other calls. The vector is neither copyable nor
+// movable: other threads reach it by address while they append.
+template <class T>
+class ConcurrentVector {
+  static_assert(std::is_nothrow_move_constructible_v<T>, "elements are moved into their slot after it is reserved");
+
+ public:
+  static constexpr size_t kFirstSegmentSize = std::bit_floor(std::max<size_t>(1, 256 / sizeof(T)));
+
+ private:
+  static constexpr int kFirstSegmentShift = std::countr_zero(kFirstSegmentSize);
+  static constexpr int kMaxSegments = 64 - kFirstSegmentShift;
+
+  std::atomic<T*> segments_[kMaxSegments];
+  std::atomic<size_t> size_;
+
+ public:
+  class Iterator;
+  class ConstIterator;
+  using ValueType = T;
+  using Reference = T&;
+  using ConstReference = const T&;
+  using SizeType = size_t;
+
+  ConcurrentVector() noexcept;
+  ConcurrentVector(const ConcurrentVector&) = delete;
+  ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+  ~ConcurrentVector();
+
+  size_t Size() const noexcept;
+  bool Empty() const noexcept;
+
+  T& operator[](size_t) noexcept;
+  const T& operator[](size_t) const noexcept;
+  T& At(size_t);
+  const T& At(size_t) const;
+
+  T& PushBack(const T&);
+  T& PushBack(T&&);
+  template <class... Args>
+  T& EmplaceBack(Args&&... args);
+  void Clear() noexcept;
+
+  Iterator begin() noexcept;              // NOLINT
+  ConstIterator begin() const noexcept;   // NOLINT
+  Iterator end() noexcept;                // NOLINT
+  ConstIterator end() const noexcept;     // NOLINT
+
+ private:
+  static int SegmentOf(size_t idx) noexcept;
+  static size_t SegmentStart(int segment) noexcept;
+  static size_t SegmentSize(int segment) noexcept;
+  T* Segment(int segment);
+  T* Slot(size_t idx) const noexcept;
+};
+
+template <class T>
+class ConcurrentVector<T>::Iterator {
+  ConcurrentVector* owner_ = nullptr;
+  size_t idx_ = 0;
+
+ public:
+  using iterator_category = std::forward_iterator_tag;  // NOLINT
+  using value_type = T;                                  // NOLINT
+  using difference_type = ptrdiff_t;                     // NOLINT
+  using reference = T&;                                  // NOLINT
+  using pointer = T*;                                    // NOLINT
+
+  Iterator() noexcept = default;
+  Iterator(ConcurrentVector* owner, size_t idx) noexcept : owner_(owner), idx_(idx) {
+  }
+
+  T& operator*() const noexcept {
+    return (*owner_)[idx_];
+  }
+  T* operator->() const noexcept {
+    return &(*owner_)[idx_];
+  }
+  Iterator& operator++() noexcept {
+    ++idx_;
+    return *this;
+  }
+  Iterator operator++(int) noexcept {
+    return {owner_, idx_++};
+  }
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+    return lhs.idx_ == rhs.idx_;
+  }
+};
+
+template <class T>
+class ConcurrentVector<T>::ConstIterator {
+  const ConcurrentVector* owner_ = nullptr;
+  size_t idx_ = 0;
+
+ public:
+  using iterator_category = std::forward_iterator_tag;  // NOLINT
+  using value_type = T;                                  // NOLINT
+  using difference_type = ptrdiff_t;                     // NOLINT
+  using reference = const T&;                            // NOLINT
+  using pointer = const T*;                              // NOLINT
+
+  ConstIterator() noexcept = default;
+  ConstIterator(const ConcurrentVector* owner, size_t idx) noexcept : owner_(owner), idx_(idx) {
+  }
+
+  const T& operator*() const noexcept {
+    return (*owner_)[idx_];
+  }
+  const T* operator->() const noexcept {
+    return &(*owner_)[idx_];
+  }
+  ConstIterator& operator++() noexcept {
+    ++idx_;
+    return *this;
+  }
+  ConstIterator operator++(int) noexcept {
+    return {owner_, idx_++};
+  }
+  friend bool operator==(const ConstIterator& lhs, const ConstIterator& rhs) noexcept {
+    return lhs.idx_ == rhs.idx_;
+  }
+};
+
+template <class T>
+int ConcurrentVector<T>::SegmentOf(size_t idx) noexcept {
+  return std::bit_width((idx >> kFirstSegmentShift) + 1) - 1;
+}
+
+template <class T>
+size_t ConcurrentVector<T>::SegmentStart(int segment) noexcept {
+  return ((size_t{1} << segment) - 1) << kFirstSegmentShift;
+}
+
+template <class T>
+size_t ConcurrentVector<T>::SegmentSize(int segment) noexcept {
+  return kFirstSegmentSize << segment;
+}
+
+// Returns the segment, allocating it if no thread has done so yet. Threads racing for the same segment each
+// allocate one, the first compare-and-swap wins and the others free theirs.
+template <class T>
+T* ConcurrentVector<T>::Segment(int segment) {
+  auto ptr = segments_[segment].load(std::memory_order_acquire);
+  if (ptr) {
+    return ptr;
+  }
+  auto fresh = std::allocator<T>().allocate(SegmentSize(segment));
+  if (segments_[segment].compare_exchange_strong(ptr, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    return fresh;
+  }
+  std::allocator<T>().deallocate(fresh, SegmentSize(segment));
+  return ptr;
+}
+
+template <class T>
+T* ConcurrentVector<T>::Slot(size_t idx) const noexcept {
+  auto segment = SegmentOf(idx);
+  return segments_[segment].load(std::memory_order_acquire) + (idx - SegmentStart(segment));
+}
+
+template <class T>
+ConcurrentVector<T>::ConcurrentVector() noexcept : segments_(), size_(0) {
+}
+
+template <class T>
+ConcurrentVector<T>::~ConcurrentVector() {
+  Clear();
+  for (int segment = 0; segment < kMaxSegments; ++segment) {
+    if (auto ptr = segments_[segment].load(std::memory_order_relaxed)) {
+      std::allocator<T>().deallocate(ptr, SegmentSize(segment));
+    }
+  }
+}
+
+template <class T>
+size_t ConcurrentVector<T>::Size() const noexcept {
+  return size_.load(std::memory_order_acquire);
+}
+
+template <class T>
+bool ConcurrentVector<T>::Empty() const noexcept {
+  return Size() == 0;
+}
+
+template <class T>
+T& ConcurrentVector<T>::operator[](size_t idx) noexcept {
+  return *Slot(idx);
+}
+
+template <class T>
+const T& ConcurrentVector<T>::operator[](size_t idx) const noexcept {
+  return *Slot(idx);
+}
+
+template <class T>
+T& ConcurrentVector<T>::At(size_t idx) {
+  if (idx >= Size()) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return *Slot(idx);
+}
+
+template <class T>
+const T& ConcurrentVector<T>::At(size_t idx) const {
+  if (idx >= Size()) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return *Slot(idx);
+}
+
+template <class T>
+T& ConcurrentVector<T>::PushBack(const T& value) {
+  return EmplaceBack(value);
+}
+
+template <class T>
+T& ConcurrentVector<T>::PushBack(T&& value) {
+  return EmplaceBack(std::move(value));
+}
+
+// The element is built and the segment the next slot most likely falls into is allocated before the slot is
+// reserved, so a throwing constructor or a failed allocation normally leaves nothing behind. A reserved slot
+// cannot be given back, though: if its segment still has to be allocated afterwards and that fails, the
+// process is terminated rather than left with a hole in the vector.
+template <class T>
+template <class... Args>
+T& ConcurrentVector<T>::EmplaceBack(Args&&... args) {
+  T value(std::forward<Args>(args)...);
+  Segment(SegmentOf(size_.load(std::memory_order_relaxed)));
+  auto idx = size_.fetch_add(1, std::memory_order_acq_rel);
+  auto place = [this, idx, &value]() noexcept {
+    auto segment = SegmentOf(idx);
+    return new (Segment(segment) + (idx - SegmentStart(segment))) T(std::move(value));
+  };
+  return *place();
+}
+
+// Destroys the elements but keeps the segments for reuse.
+template <class T>
+void ConcurrentVector<T>::Clear() noexcept {
+  auto size = size_.load(std::memory_order_relaxed);
+  for (int segment = 0; segment < kMaxSegments && SegmentStart(segment) < size; ++segment) {
+    auto ptr = segments_[segment].load(std::memory_order_relaxed);
+    std::destroy_n(ptr, std::min(SegmentSize(segment), size - SegmentStart(segment)));
+  }
+  size_.store(0, std::memory_order_relaxed);
+}
+
+template <class T>
+typename ConcurrentVector<T>::Iterator ConcurrentVector<T>::begin() noexcept {
+  return {this, 0};
+}
+
+template <class T>
+typename ConcurrentVector<T>::ConstIterator ConcurrentVector<T>::begin() const noexcept {
+  return {this, 0};
+}
+
+template <class T>
+typename ConcurrentVector<T>::Iterator ConcurrentVector<T>::end() noexcept {
+  return {this, Size()};
+}
+
+template <class T>
+typename ConcurrentVector<T>::ConstIterator ConcurrentVector<T>::end() const noexcept {
+  return {this, Size()};
+}
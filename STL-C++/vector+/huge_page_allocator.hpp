@@ -0,0 +1,97 @@
+#pragma once
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Allocator for multi-gigabyte buffers of trivially relocatable elements (Linux only). Requests of at least
+// Threshold bytes are mapped directly with mmap and advised MADV_HUGEPAGE. Growing such a buffer uses
+// mremap(MREMAP_MAYMOVE): the kernel moves page table entries instead of copying the data, so the old and
+// the new buffer never exist side by side. Vector picks this up through reallocate().
+template <class T, size_t Threshold = (size_t{64} << 20)>
+class HugePageAllocator {
+ public:
+  using value_type = T;                      // NOLINT
+  using is_always_equal = std::true_type;    // NOLINT
+
+  static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+  template <class U>
+  struct rebind {  // NOLINT
+    using other = HugePageAllocator<U, Threshold>;  // NOLINT
+  };
+
+  HugePageAllocator() noexcept = default;
+  template <class U>
+  HugePageAllocator(const HugePageAllocator<U, Threshold>&) noexcept {  // NOLINT
+  }
+
+  T* allocate(size_t n) {  // NOLINT
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    if (!IsMapped(n)) {
+      return std::allocator<T>().allocate(n);
+    }
+    auto ptr = mmap(nullptr, MappedBytes(n), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    madvise(ptr, MappedBytes(n), MADV_HUGEPAGE);
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept {  // NOLINT
+    if (IsMapped(n)) {
+      munmap(ptr, MappedBytes(n));
+    } else {
+      std::allocator<T>().deallocate(ptr, n);
+    }
+  }
+
+  // Resizes the buffer of old_n elements to new_n, preserving the first used ones. Mapped buffers are
+  // remapped; when one of the sizes is below the threshold the elements are copied as usual.
+  T* reallocate(T* ptr, size_t old_n, size_t new_n, size_t used) {  // NOLINT
+    if (ptr && IsMapped(old_n) && IsMapped(new_n)) {
+      if (MappedBytes(old_n) == MappedBytes(new_n)) {
+        return ptr;
+      }
+      auto new_ptr = mremap(ptr, MappedBytes(old_n), MappedBytes(new_n), MREMAP_MAYMOVE);
+      if (new_ptr == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      madvise(new_ptr, MappedBytes(new_n), MADV_HUGEPAGE);
+      return static_cast<T*>(new_ptr);
+    }
+    auto new_ptr = new_n == 0 ? nullptr : allocate(new_n);
+    if (used != 0) {
+      std::memcpy(static_cast<void*>(new_ptr), static_cast<const void*>(ptr), used * sizeof(T));
+    }
+    if (ptr) {
+      deallocate(ptr, old_n);
+    }
+    return new_ptr;
+  }
+
+  template <class U>
+  bool operator==(const HugePageAllocator<U, Threshold>&) const noexcept {
+    return true;
+  }
+  template <class U>
+  bool operator!=(const HugePageAllocator<U, Threshold>&) const noexcept {
+    return false;
+  }
+
+ private:
+  static bool IsMapped(size_t n) noexcept {
+    return n * sizeof(T) >= Threshold;
+  }
+
+  static size_t MappedBytes(size_t n) noexcept {
+    return (n * sizeof(T) + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+};
@@ -0,0 +1,69 @@
+// Peak resident memory of PushBack growth with std::allocator against HugePageAllocator (Linux only).
+//
+//   g++ -std=c++20 -O2 huge_page_allocator_bench.cpp -o huge_page_allocator_bench && ./huge_page_allocator_bench
+//
+// Every configuration runs in its own child process and reports that process's peak RSS (VmHWM), so the
+// moment during a reallocation where the old and the new buffer are both resident is included. Growing to
+// just past a doubling is the case that shows it: the copying allocator briefly holds the full old buffer
+// plus its copy, while the final vector is barely larger than the old buffer.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "huge_page_allocator.hpp"
+#include "vector.hpp"
+
+// VmHWM or VmRSS of this process in MiB.
+double StatusMiB(const char* key) {
+  auto file = std::fopen("/proc/self/status", "r");
+  char line[256];
+  double kib = 0;
+  while (file && std::fgets(line, sizeof(line), file)) {
+    if (std::strncmp(line, key, std::strlen(key)) == 0) {
+      kib = std::atof(line + std::strlen(key) + 1);
+    }
+  }
+  if (file) {
+    std::fclose(file);
+  }
+  return kib / 1024;
+}
+
+template <class Allocator>
+void Grow(const char* name, size_t n) {
+  auto base = StatusMiB("VmRSS");
+  auto start = std::chrono::steady_clock::now();
+  Vector<double, Allocator> v;
+  for (size_t i = 0; i < n; ++i) {
+    v.PushBack(static_cast<double>(i));
+  }
+  auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  std::printf("%-18s %10zu doubles (%5.0f MiB): peak RSS %6.0f MiB, final RSS %6.0f MiB, %6.0f ms\n", name, n,
+              static_cast<double>(n * sizeof(double)) / (1 << 20), StatusMiB("VmHWM") - base,
+              StatusMiB("VmRSS") - base, ms);
+}
+
+template <class Allocator>
+void InChild(const char* name, size_t n) {
+  std::fflush(stdout);
+  auto pid = fork();
+  if (pid == 0) {
+    Grow<Allocator>(name, n);
+    std::fflush(stdout);
+    std::_Exit(0);
+  }
+  waitpid(pid, nullptr, 0);
+}
+
+int main() {
+  for (size_t n : {(size_t{1} << 25) + 1, size_t{1} << 26}) {
+    InChild<std::allocator<double>>("std::allocator", n);
+    InChild<HugePageAllocator<double>>("HugePageAllocator", n);
+  }
+}
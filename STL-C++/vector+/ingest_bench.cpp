@@ -0,0 +1,101 @@
+// Reads a file into a Vector<char> chunk by chunk, growing the vector in several ways before every read():
+// Resize(n, 0), which zero-fills the chunk read() then overwrites; Resize(n); both again after a doubling
+// Reserve, which separates the zeroing from Resize's exact-size growth; ResizeForOverwrite(n) and
+// AppendUninitialized(chunk). Linux only.
+//
+//   g++ -std=c++20 -O2 ingest_bench.cpp -o ingest_bench && ./ingest_bench [file]
+//
+// Without an argument a 32 MiB temporary file is used; it stays in the page cache, so the loop measures the
+// vector rather than the disk.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "vector.hpp"
+
+constexpr size_t kChunk = size_t{64} << 10;
+constexpr int kRepetitions = 5;
+
+template <class Grow>
+double Ingest(const char* path, size_t& total, Grow grow) {
+  auto best = 1e30;
+  for (int rep = 0; rep < kRepetitions; ++rep) {
+    auto fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      std::perror(path);
+      std::exit(1);
+    }
+    auto start = std::chrono::steady_clock::now();
+    Vector<char> buffer;
+    while (true) {
+      auto old_size = buffer.Size();
+      auto dest = grow(buffer, old_size);
+      auto got = read(fd, dest, kChunk);
+      buffer.Resize(old_size + static_cast<size_t>(std::max<ssize_t>(got, 0)));
+      if (got <= 0) {
+        break;
+      }
+    }
+    best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    total = buffer.Size();
+    close(fd);
+  }
+  return best;
+}
+
+template <class Grow>
+void Run(const char* name, const char* path, Grow grow) {
+  size_t total = 0;
+  auto ms = Ingest(path, total, grow);
+  std::printf("%-24s %8.1f ms  %7.0f MB/s\n", name, ms, static_cast<double>(total) / 1e3 / ms);
+}
+
+int main(int argc, char** argv) {
+  char temp[] = "/tmp/ingest_bench_XXXXXX";
+  const char* path = argc > 1 ? argv[1] : temp;
+  if (argc <= 1) {
+    auto fd = mkstemp(temp);
+    std::vector<char> block(size_t{1} << 20, 'x');
+    for (int i = 0; i < 32; ++i) {
+      if (write(fd, block.data(), block.size()) != static_cast<ssize_t>(block.size())) {
+        std::perror("write");
+        return 1;
+      }
+    }
+    close(fd);
+  }
+
+  Run("Resize(n, 0)", path, [](Vector<char>& v, size_t size) {
+    v.Resize(size + kChunk, 0);
+    return v.Data() + size;
+  });
+  Run("Resize(n)", path, [](Vector<char>& v, size_t size) {
+    v.Resize(size + kChunk);
+    return v.Data() + size;
+  });
+  Run("Reserve + Resize(n, 0)", path, [](Vector<char>& v, size_t size) {
+    v.Reserve(size + kChunk > v.Capacity() ? std::max(2 * v.Capacity(), size + kChunk) : 0);
+    v.Resize(size + kChunk, 0);
+    return v.Data() + size;
+  });
+  Run("Reserve + Resize(n)", path, [](Vector<char>& v, size_t size) {
+    v.Reserve(size + kChunk > v.Capacity() ? std::max(2 * v.Capacity(), size + kChunk) : 0);
+    v.Resize(size + kChunk);
+    return v.Data() + size;
+  });
+  Run("ResizeForOverwrite(n)", path, [](Vector<char>& v, size_t size) {
+    v.ResizeForOverwrite(size + kChunk);
+    return v.Data() + size;
+  });
+  Run("AppendUninitialized", path, [](Vector<char>& v, size_t) { return v.AppendUninitialized(kChunk).data(); });
+
+  if (argc <= 1) {
+    unlink(temp);
+  }
+}
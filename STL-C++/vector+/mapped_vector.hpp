@@ -0,0 +1,468 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include "vector.hpp"
+
+enum class MappedVectorMode {
+  kReadOnly,   // Opens an existing file; writes through operator[] stay private, growing throws
+  kReadWrite,  // Opens an existing file or creates an empty one
+  kCreate,     // Creates the file or truncates it to an empty vector
+};
+
+// Vector of trivially copyable elements that lives in a file mapped with mmap (Linux only). The file starts with
+// a header (magic, version, element size, element count) followed by the elements, so opening a table of any
+// size only maps it: pages are read on first access. Growth extends the file with ftruncate and the mapping with
+// mremap. The element API matches Vector; changes reach the file when the pages are written back or on Flush().
+template <class T, class GrowthPolicy = DoublingGrowth>
+class MappedVector {
+  static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores elements as raw bytes");
+
+  struct Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t size;
+  };
+
+ public:
+  static constexpr uint64_t kMagic = 0x524f544345564d4d;  // "MMVECTOR" read as little-endian
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kHeaderSize = 64;
+  static_assert(alignof(T) <= kHeaderSize, "elements must be aligned within the mapping");
+
+  using Iterator = T*;
+  using ConstIterator = const T*;
+  using ReverseIterator = std::reverse_iterator<T*>;
+  using ConstReverseIterator = std::reverse_iterator<const T*>;
+  using ValueType = T;
+  using Pointer = T*;
+  using ConstPointer = const T*;
+  using Reference = T&;
+  using ConstReference = const T&;
+  using SizeType = size_t;
+
+  explicit MappedVector(const char* path, MappedVectorMode mode = MappedVectorMode::kReadWrite);
+  MappedVector(const MappedVector&) = delete;
+  MappedVector(MappedVector&&) noexcept;
+  MappedVector& operator=(const MappedVector&) = delete;
+  MappedVector& operator=(MappedVector&&) noexcept;
+  ~MappedVector();
+
+  bool ReadOnly() const noexcept;
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  bool Empty() const noexcept;
+
+  T& operator[](size_t) noexcept;
+  const T& operator[](size_t) const noexcept;
+  T& At(size_t);
+  const T& At(size_t) const;
+  T& Front() noexcept;
+  const T& Front() const noexcept;
+  T& Back() noexcept;
+  const T& Back() const noexcept;
+  T* Data() noexcept;
+  const T* Data() const noexcept;
+
+  void Swap(MappedVector&) noexcept;
+  void Resize(size_t);
+  void Resize(size_t, const T&);
+  void Reserve(size_t);
+  void ShrinkToFit();
+  void Clear() noexcept;
+  void PushBack(const T&);
+  template <class... Args>
+  void EmplaceBack(Args&&... args);
+  void PopBack() noexcept;
+  void Flush();
+
+  Iterator begin() noexcept;                      // NOLINT
+  ConstIterator begin() const noexcept;           // NOLINT
+  ConstIterator cbegin() const noexcept;          // NOLINT
+  Iterator end() noexcept;                        // NOLINT
+  ConstIterator end() const noexcept;             // NOLINT
+  ConstIterator cend() const noexcept;            // NOLINT
+  ReverseIterator rbegin() noexcept;              // NOLINT
+  ConstReverseIterator rbegin() const noexcept;   // NOLINT
+  ConstReverseIterator crbegin() const noexcept;  // NOLINT
+  ReverseIterator rend() noexcept;                // NOLINT
+  ConstReverseIterator rend() const noexcept;     // NOLINT
+  ConstReverseIterator crend() const noexcept;    // NOLINT
+
+ private:
+  int fd_ = -1;
+  std::byte* base_ = nullptr;
+  size_t capacity_ = 0;
+  bool read_only_ = false;
+
+  Header* GetHeader() const noexcept;
+  static size_t FileBytes(size_t cap) noexcept;
+  void Close() noexcept;
+  void Remap(size_t new_cap);
+  void CheckWritable() const;
+  [[noreturn]] static void ThrowErrno(const char* what);
+};
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::ThrowErrno(const char* what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::FileBytes(size_t cap) noexcept {
+  return kHeaderSize + cap * sizeof(T);
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::Header* MappedVector<T, GrowthPolicy>::GetHeader() const noexcept {
+  return reinterpret_cast<Header*>(base_);
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(const char* path, MappedVectorMode mode)
+    : read_only_(mode == MappedVectorMode::kReadOnly) {
+  auto flags = read_only_ ? O_RDONLY : O_RDWR | O_CREAT | (mode == MappedVectorMode::kCreate ? O_TRUNC : 0);
+  fd_ = open(path, flags | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    ThrowErrno("open");
+  }
+  try {
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+      ThrowErrno("fstat");
+    }
+    auto file_bytes = static_cast<size_t>(st.st_size);
+    auto is_new = file_bytes == 0 && !read_only_;
+    if (is_new) {
+      if (ftruncate(fd_, static_cast<off_t>(kHeaderSize)) != 0) {
+        ThrowErrno("ftruncate");
+      }
+      file_bytes = kHeaderSize;
+    }
+    if (file_bytes < kHeaderSize) {
+      throw std::runtime_error("BadMappedVectorFile");
+    }
+    // A private writable mapping keeps read-only opens zero-copy while making stray writes copy-on-write.
+    auto ptr = read_only_ ? mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0)
+                          : mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (ptr == MAP_FAILED) {
+      ThrowErrno("mmap");
+    }
+    base_ = static_cast<std::byte*>(ptr);
+    capacity_ = (file_bytes - kHeaderSize) / sizeof(T);
+    auto header = GetHeader();
+    if (is_new) {
+      *header = Header{kMagic, kVersion, sizeof(T), 0};
+    } else if (header->magic != kMagic || header->version != kVersion || header->element_size != sizeof(T) ||
+               header->size > capacity_) {
+      throw std::runtime_error("BadMappedVectorFile");
+    }
+  } catch (...) {
+    Close();
+    throw;
+  }
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(MappedVector&& other) noexcept
+    : fd_(other.fd_), base_(other.base_), capacity_(other.capacity_), read_only_(other.read_only_) {
+  other.fd_ = -1;
+  other.base_ = nullptr;
+  other.capacity_ = 0;
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy>& MappedVector<T, GrowthPolicy>::operator=(MappedVector&& other) noexcept {
+  if (this != &other) {
+    MappedVector tmp(std::move(other));
+    Swap(tmp);
+  }
+  return *this;
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy>::~MappedVector() {
+  Close();
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Close() noexcept {
+  if (base_) {
+    munmap(base_, FileBytes(capacity_));
+    base_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  capacity_ = 0;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::CheckWritable() const {
+  if (read_only_) {
+    throw std::logic_error("ReadOnly");
+  }
+}
+
+// Resizes the file and the mapping to new_cap elements; on failure both are left as they were.
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Remap(size_t new_cap) {
+  CheckWritable();
+  if (new_cap > (static_cast<size_t>(-1) - kHeaderSize) / sizeof(T)) {
+    throw std::length_error("LengthError");
+  }
+  if (new_cap > capacity_ && ftruncate(fd_, static_cast<off_t>(FileBytes(new_cap))) != 0) {
+    ThrowErrno("ftruncate");
+  }
+  auto ptr = mremap(base_, FileBytes(capacity_), FileBytes(new_cap), MREMAP_MAYMOVE);
+  if (ptr == MAP_FAILED) {
+    auto error = errno;
+    if (new_cap > capacity_) {
+      static_cast<void>(ftruncate(fd_, static_cast<off_t>(FileBytes(capacity_))));
+    }
+    throw std::system_error(error, std::generic_category(), "mremap");
+  }
+  base_ = static_cast<std::byte*>(ptr);
+  if (new_cap < capacity_) {
+    static_cast<void>(ftruncate(fd_, static_cast<off_t>(FileBytes(new_cap))));
+  }
+  capacity_ = new_cap;
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::ReadOnly() const noexcept {
+  return read_only_;
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Size() const noexcept {
+  return base_ ? GetHeader()->size : 0;
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Capacity() const noexcept {
+  return capacity_;
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::Empty() const noexcept {
+  return Size() == 0;
+}
+
+template <class T, class GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::operator[](size_t idx) noexcept {
+  return Data()[idx];
+}
+
+template <class T, class GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::operator[](size_t idx) const noexcept {
+  return Data()[idx];
+}
+
+template <class T, class GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::At(size_t idx) {
+  if (idx >= Size()) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return Data()[idx];
+}
+
+template <class T, class GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::At(size_t idx) const {
+  if (idx >= Size()) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return Data()[idx];
+}
+
+template <class T, class GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::Front() noexcept {
+  return Data()[0];
+}
+
+template <class T, class GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::Front() const noexcept {
+  return Data()[0];
+}
+
+template <class T, class GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::Back() noexcept {
+  return Data()[Size() - 1];
+}
+
+template <class T, class GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::Back() const noexcept {
+  return Data()[Size() - 1];
+}
+
+template <class T, class GrowthPolicy>
+T* MappedVector<T, GrowthPolicy>::Data() noexcept {
+  return base_ ? reinterpret_cast<T*>(base_ + kHeaderSize) : nullptr;
+}
+
+template <class T, class GrowthPolicy>
+const T* MappedVector<T, GrowthPolicy>::Data() const noexcept {
+  return base_ ? reinterpret_cast<const T*>(base_ + kHeaderSize) : nullptr;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Swap(MappedVector& other) noexcept {
+  std::swap(fd_, other.fd_);
+  std::swap(base_, other.base_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(read_only_, other.read_only_);
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Resize(size_t n) {
+  CheckWritable();
+  if (n > capacity_) {
+    Remap(GrowthPolicy::kAmortizedResize ? GrowthPolicy::Grow(Size(), n, sizeof(T)) : n);
+  }
+  if (n > Size()) {
+    std::uninitialized_default_construct(end(), begin() + n);
+  }
+  GetHeader()->size = n;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Resize(size_t n, const T& value) {
+  CheckWritable();
+  if (n > capacity_) {
+    T copy(value);
+    Remap(GrowthPolicy::kAmortizedResize ? GrowthPolicy::Grow(Size(), n, sizeof(T)) : n);
+    std::uninitialized_fill(end(), begin() + n, copy);
+  } else if (n > Size()) {
+    std::uninitialized_fill(end(), begin() + n, value);
+  }
+  GetHeader()->size = n;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Reserve(size_t new_cap) {
+  if (new_cap > capacity_) {
+    Remap(new_cap);
+  }
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::ShrinkToFit() {
+  if (Size() < capacity_) {
+    Remap(Size());
+  }
+}
+
+// Trivially copyable elements need no destruction, so this only resets the count.
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Clear() noexcept {
+  if (base_) {
+    GetHeader()->size = 0;
+  }
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::PushBack(const T& value) {
+  EmplaceBack(value);
+}
+
+template <class T, class GrowthPolicy>
+template <class... Args>
+void MappedVector<T, GrowthPolicy>::EmplaceBack(Args&&... args) {
+  CheckWritable();
+  T value(std::forward<Args>(args)...);
+  auto size = Size();
+  if (size == capacity_) {
+    Remap(GrowthPolicy::Grow(size, size + 1, sizeof(T)));
+  }
+  new (Data() + size) T(value);
+  GetHeader()->size = size + 1;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::PopBack() noexcept {
+  --GetHeader()->size;
+}
+
+// Writes dirty pages back synchronously; without it the kernel does so on its own schedule.
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Flush() {
+  CheckWritable();
+  if (msync(base_, FileBytes(capacity_), MS_SYNC) != 0) {
+    ThrowErrno("msync");
+  }
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::Iterator MappedVector<T, GrowthPolicy>::begin() noexcept {
+  return Data();
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstIterator MappedVector<T, GrowthPolicy>::begin() const noexcept {
+  return Data();
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstIterator MappedVector<T, GrowthPolicy>::cbegin() const noexcept {
+  return Data();
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::Iterator MappedVector<T, GrowthPolicy>::end() noexcept {
+  return Data() + Size();
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstIterator MappedVector<T, GrowthPolicy>::end() const noexcept {
+  return Data() + Size();
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstIterator MappedVector<T, GrowthPolicy>::cend() const noexcept {
+  return Data() + Size();
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ReverseIterator MappedVector<T, GrowthPolicy>::rbegin() noexcept {
+  return ReverseIterator(end());
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstReverseIterator MappedVector<T, GrowthPolicy>::rbegin() const noexcept {
+  return ConstReverseIterator(end());
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstReverseIterator MappedVector<T, GrowthPolicy>::crbegin()
+    const noexcept {
+  return ConstReverseIterator(cend());
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ReverseIterator MappedVector<T, GrowthPolicy>::rend() noexcept {
+  return ReverseIterator(begin());
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstReverseIterator MappedVector<T, GrowthPolicy>::rend() const noexcept {
+  return ConstReverseIterator(begin());
+}
+
+template <class T, class GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::ConstReverseIterator MappedVector<T, GrowthPolicy>::crend() const noexcept {
+  return ConstReverseIterator(cbegin());
+}
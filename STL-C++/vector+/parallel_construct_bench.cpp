@@ -0,0 +1,57 @@
+// Fill construction, copy construction and Resize(n, value) of a large Vector<double>, sequential against
+// ParallelConstruction with 1, 2, 4 and hardware_concurrency() threads.
+//
+//   g++ -std=c++20 -O2 -pthread parallel_construct_bench.cpp -o parallel_construct_bench
+//   ./parallel_construct_bench [MiB]
+//
+// Every buffer is freshly allocated, so the timings include the page faults of the first touch, which is
+// what the parallel policy spreads over threads (and NUMA nodes).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "vector.hpp"
+
+template <class F>
+double Millis(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Report(const char* name, size_t threads, size_t n, double fill, double copy, double resize) {
+  auto gbs = [n](double ms) { return static_cast<double>(n * sizeof(double)) / 1e6 / ms; };
+  std::printf("%-12s %2zu thread(s): fill %7.1f ms (%5.2f GB/s)  copy %7.1f ms (%5.2f GB/s)  "
+              "resize %7.1f ms (%5.2f GB/s)\n",
+              name, threads, fill, gbs(fill), copy, gbs(copy), resize, gbs(resize));
+}
+
+int main(int argc, char** argv) {
+  size_t mib = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+  size_t n = (mib << 20) / sizeof(double);
+  Vector<double> source(n, 1.0);
+  {
+    Vector<double> warm_up(source);
+  }
+
+  double fill = Millis([n] { Vector<double> v(n, 2.0); });
+  double copy = Millis([&source] { Vector<double> v(source); });
+  double resize = Millis([n] {
+    Vector<double> v;
+    v.Resize(n, 3.0);
+  });
+  Report("sequential", 1, n, fill, copy, resize);
+
+  for (size_t threads : {size_t{1}, size_t{2}, size_t{4}, size_t{std::thread::hardware_concurrency()}}) {
+    ParallelConstruction policy{threads, size_t{64} << 20};
+    fill = Millis([&policy, n] { Vector<double> v(policy, n, 2.0); });
+    copy = Millis([&policy, &source] { Vector<double> v(policy, source); });
+    resize = Millis([&policy, n] {
+      Vector<double> v;
+      v.Resize(policy, n, 3.0);
+    });
+    Report("parallel", threads, n, fill, copy, resize);
+  }
+}
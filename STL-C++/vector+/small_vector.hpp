@@ -0,0 +1,598 @@
+#pragma once
+
+#include "vector.hpp"
+
+// Vector that keeps up to N elements inside the object and moves them to the heap only when it outgrows
+// them. Growth, relocation and comparisons go through the same detail:: helpers as Vector.
+template <class T, size_t N, class Allocator = std::allocator<T>, class GrowthPolicy = DoublingGrowth>
+class SmallVector {
+ private:
+  static_assert(N > 0, "use Vector for N == 0");
+  using AllocTraits = std::allocator_traits<Allocator>;
+  static_assert(std::is_same_v<typename AllocTraits::value_type, T>, "Allocator::value_type must be T");
+  static_assert(std::is_same_v<typename AllocTraits::pointer, T*>, "fancy pointers are not supported");
+
+  T* data_;
+  size_t size_;
+  size_t capacity_;
+  [[no_unique_address]] Allocator alloc_;
+  alignas(T) std::byte storage_[N * sizeof(T)];
+
+ public:
+  using Iterator = T*;
+  using ConstIterator = const T*;
+  using ReverseIterator = std::reverse_iterator<T*>;
+  using ConstReverseIterator = std::reverse_iterator<const T*>;
+  using ValueType = T;
+  using AllocatorType = Allocator;
+  using Pointer = T*;
+  using ConstPointer = const T*;
+  using Reference = T&;
+  using ConstReference = const T&;
+  using SizeType = size_t;
+
+  static constexpr size_t kInlineCapacity = N;
+
+  SmallVector() noexcept(noexcept(Allocator()));
+  explicit SmallVector(const Allocator&) noexcept;
+  explicit SmallVector(size_t, const Allocator& = Allocator());
+  SmallVector(size_t, const T&, const Allocator& = Allocator());
+  SmallVector(std::initializer_list<T>, const Allocator& = Allocator());
+  template <class ForwardIt, detail::EnifForwardIt<ForwardIt> = 0>
+  SmallVector(ForwardIt, ForwardIt, const Allocator& = Allocator());
+
+  SmallVector(const SmallVector&);
+  SmallVector(const SmallVector&, const Allocator&);
+  SmallVector(SmallVector&&) noexcept;
+  SmallVector& operator=(const SmallVector&);
+  SmallVector& operator=(SmallVector&&) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                 AllocTraits::is_always_equal::value);
+  ~SmallVector();
+
+  Allocator GetAllocator() const noexcept;
+  bool IsInline() const noexcept;
+
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  bool Empty() const noexcept;
+
+  T& operator[](size_t) noexcept;
+  const T& operator[](size_t) const noexcept;
+  T& At(size_t);
+  const T& At(size_t) const;
+  T& Front() noexcept;
+  const T& Front() const noexcept;
+  T& Back() noexcept;
+  const T& Back() const noexcept;
+  T* Data() noexcept;
+  const T* Data() const noexcept;
+
+  void Swap(SmallVector&) noexcept;
+  void Resize(size_t);
+  void Resize(size_t, const T&);
+  void Reserve(size_t);
+  void ShrinkToFit();
+  void Clear() noexcept;
+  void PushBack(const T&);
+  void PushBack(T&&);
+  template <class... Args>
+  void EmplaceBack(Args&&... args);
+  void PopBack() noexcept;
+
+  Iterator begin() noexcept;                      // NOLINT
+  ConstIterator begin() const noexcept;           // NOLINT
+  ConstIterator cbegin() const noexcept;          // NOLINT
+  Iterator end() noexcept;                        // NOLINT
+  ConstIterator end() const noexcept;             // NOLINT
+  ConstIterator cend() const noexcept;            // NOLINT
+  ReverseIterator rbegin() noexcept;              // NOLINT
+  ConstReverseIterator rbegin() const noexcept;   // NOLINT
+  ConstReverseIterator crbegin() const noexcept;  // NOLINT
+  ReverseIterator rend() noexcept;                // NOLINT
+  ConstReverseIterator rend() const noexcept;     // NOLINT
+  ConstReverseIterator crend() const noexcept;    // NOLINT
+
+ private:
+  T* InlineData() noexcept;
+  template <class Construct>
+  void ConstructWith(size_t, Construct);
+  void ReleaseStorage() noexcept;
+  void TakeFrom(SmallVector&) noexcept;
+  size_t GrowTo(size_t) const noexcept;
+  void NoteReallocation(size_t) const noexcept;
+  void Reallocate(size_t);
+  template <class Construct>
+  void ReallocateAndConstruct(size_t, size_t, Construct);
+};
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+T* SmallVector<T, N, Allocator, GrowthPolicy>::InlineData() noexcept {
+  return reinterpret_cast<T*>(storage_);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool SmallVector<T, N, Allocator, GrowthPolicy>::IsInline() const noexcept {
+  return data_ == reinterpret_cast<const T*>(storage_);
+}
+
+// Fills an empty inline vector with n elements, spilling to an exact-size heap buffer if they do not fit.
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+template <class Construct>
+void SmallVector<T, N, Allocator, GrowthPolicy>::ConstructWith(size_t n, Construct construct) {
+  if (n <= N) {
+    construct(data_, data_ + n);
+    size_ = n;
+    return;
+  }
+  auto heap = AllocTraits::allocate(alloc_, n);
+  try {
+    construct(heap, heap + n);
+  } catch (...) {
+    AllocTraits::deallocate(alloc_, heap, n);
+    throw;
+  }
+  data_ = heap;
+  size_ = n;
+  capacity_ = n;
+}
+
+// Destroys the elements and returns to the empty inline state.
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::ReleaseStorage() noexcept {
+  Clear();
+  if (!IsInline()) {
+    AllocTraits::deallocate(alloc_, data_, capacity_);
+    data_ = InlineData();
+    capacity_ = N;
+  }
+}
+
+// Moves the contents of other into empty inline *this; the allocators must already be equal.
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::TakeFrom(SmallVector& other) noexcept {
+  if (other.IsInline()) {
+    detail::UninitializedRelocate(other.begin(), other.end(), data_);
+  } else {
+    data_ = other.data_;
+    capacity_ = other.capacity_;
+    other.data_ = other.InlineData();
+    other.capacity_ = N;
+  }
+  size_ = other.size_;
+  other.size_ = 0;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector() noexcept(noexcept(Allocator()))
+    : data_(InlineData()), size_(0), capacity_(N), alloc_() {
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const Allocator& alloc) noexcept
+    : data_(InlineData()), size_(0), capacity_(N), alloc_(alloc) {
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(size_t n, const Allocator& alloc) : SmallVector(alloc) {
+  ConstructWith(n, [](T* first, T* last) { std::uninitialized_default_construct(first, last); });
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(size_t n, const T& value, const Allocator& alloc)
+    : SmallVector(alloc) {
+  ConstructWith(n, [&value](T* first, T* last) { std::uninitialized_fill(first, last, value); });
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(std::initializer_list<T> il, const Allocator& alloc)
+    : SmallVector(alloc) {
+  ConstructWith(il.size(), [&il](T* first, T*) { std::uninitialized_copy(il.begin(), il.end(), first); });
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+template <class ForwardIt, detail::EnifForwardIt<ForwardIt>>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(ForwardIt start, ForwardIt finish, const Allocator& alloc)
+    : SmallVector(alloc) {
+  ConstructWith(static_cast<size_t>(std::distance(start, finish)),
+                [&start, &finish](T* first, T*) { std::uninitialized_copy(start, finish, first); });
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector& other)
+    : SmallVector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector& other, const Allocator& alloc)
+    : SmallVector(alloc) {
+  ConstructWith(other.size_,
+                [&other](T* first, T*) { std::uninitialized_copy(other.begin(), other.end(), first); });
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(SmallVector&& other) noexcept : SmallVector(other.alloc_) {
+  TakeFrom(other);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>&
+SmallVector<T, N, Allocator, GrowthPolicy>::operator=(const SmallVector& other) {
+  if (this != &other) {
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+      SmallVector tmp(other, other.alloc_);
+      ReleaseStorage();
+      alloc_ = tmp.alloc_;
+      TakeFrom(tmp);
+    } else {
+      SmallVector tmp(other, alloc_);
+      ReleaseStorage();
+      TakeFrom(tmp);
+    }
+  }
+  return *this;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>&
+SmallVector<T, N, Allocator, GrowthPolicy>::operator=(SmallVector&& other) noexcept(
+    AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+  if (this != &other) {
+    if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+      ReleaseStorage();
+      alloc_ = std::move(other.alloc_);
+      TakeFrom(other);
+    } else if constexpr (AllocTraits::is_always_equal::value) {
+      ReleaseStorage();
+      TakeFrom(other);
+    } else {
+      if (other.IsInline() || alloc_ == other.alloc_) {
+        ReleaseStorage();
+        TakeFrom(other);
+      } else {
+        SmallVector tmp(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), alloc_);
+        ReleaseStorage();
+        TakeFrom(tmp);
+      }
+    }
+  }
+  return *this;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::~SmallVector() {
+  ReleaseStorage();
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+Allocator SmallVector<T, N, Allocator, GrowthPolicy>::GetAllocator() const noexcept {
+  return alloc_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Clear() noexcept {
+  std::destroy(begin(), end());
+  size_ = 0;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+size_t SmallVector<T, N, Allocator, GrowthPolicy>::Size() const noexcept {
+  return size_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+size_t SmallVector<T, N, Allocator, GrowthPolicy>::Capacity() const noexcept {
+  return capacity_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool SmallVector<T, N, Allocator, GrowthPolicy>::Empty() const noexcept {
+  return (size_ == 0);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::operator[](size_t i) noexcept {
+  return data_[i];
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::operator[](size_t i) const noexcept {
+  return data_[i];
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::At(size_t i) {
+  if (i >= size_) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return data_[i];
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::At(size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return data_[i];
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::Front() noexcept {
+  return *begin();
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::Front() const noexcept {
+  return *cbegin();
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::Back() noexcept {
+  return *(end() - 1);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::Back() const noexcept {
+  return *(cend() - 1);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+T* SmallVector<T, N, Allocator, GrowthPolicy>::Data() noexcept {
+  return data_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+const T* SmallVector<T, N, Allocator, GrowthPolicy>::Data() const noexcept {
+  return data_;
+}
+
+// Two heap buffers are exchanged by pointer; otherwise inline elements have to be relocated through a
+// temporary. Allocators that do not propagate on swap must compare equal, as for Vector.
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Swap(SmallVector& other) noexcept {
+  if (this == &other) {
+    return;
+  }
+  if (!IsInline() && !other.IsInline()) {
+    if constexpr (AllocTraits::propagate_on_container_swap::value) {
+      std::swap(alloc_, other.alloc_);
+    }
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    return;
+  }
+  SmallVector tmp(std::move(other));
+  if constexpr (AllocTraits::propagate_on_container_swap::value) {
+    std::swap(alloc_, other.alloc_);
+  }
+  other.TakeFrom(*this);
+  TakeFrom(tmp);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+size_t SmallVector<T, N, Allocator, GrowthPolicy>::GrowTo(size_t required) const noexcept {
+  return GrowthPolicy::Grow(size_, required, sizeof(T));
+}
+
+// Spilling out of the inline buffer counts as a reallocation too, so VectorStats<T> covers both containers.
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::NoteReallocation([[maybe_unused]] size_t new_cap) const noexcept {
+#ifdef VECTOR_COLLECT_STATS
+  VectorStats<T>::Record(size_, new_cap);
+#endif
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Reallocate(size_t new_cap) {
+  NoteReallocation(new_cap);
+  auto new_data = AllocTraits::allocate(alloc_, new_cap);
+  detail::UninitializedRelocate(begin(), end(), new_data);
+  if (!IsInline()) {
+    AllocTraits::deallocate(alloc_, data_, capacity_);
+  }
+  data_ = new_data;
+  capacity_ = new_cap;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+template <class Construct>
+void SmallVector<T, N, Allocator, GrowthPolicy>::ReallocateAndConstruct(size_t new_cap, size_t new_size,
+                                                                        Construct construct) {
+  NoteReallocation(new_cap);
+  auto new_data = detail::RelocatingGrow(alloc_, data_, size_, new_cap, size_, new_size - size_, construct);
+  if (!IsInline()) {
+    AllocTraits::deallocate(alloc_, data_, capacity_);
+  }
+  data_ = new_data;
+  capacity_ = new_cap;
+  size_ = new_size;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Reserve(size_t new_cap) {
+  if (new_cap > capacity_) {
+    Reallocate(new_cap);
+  }
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Resize(size_t n) {
+  if (n <= size_) {
+    std::destroy(begin() + n, end());
+    size_ = n;
+  } else if (n <= capacity_) {
+    std::uninitialized_default_construct(end(), begin() + n);
+    size_ = n;
+  } else {
+    ReallocateAndConstruct(GrowthPolicy::kAmortizedResize ? GrowTo(n) : n, n,
+                           [](T* first, T* last) { std::uninitialized_default_construct(first, last); });
+  }
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Resize(size_t n, const T& value) {
+  if (n <= size_) {
+    std::destroy(begin() + n, end());
+    size_ = n;
+  } else if (n <= capacity_) {
+    std::uninitialized_fill(end(), begin() + n, value);
+    size_ = n;
+  } else {
+    ReallocateAndConstruct(GrowthPolicy::kAmortizedResize ? GrowTo(n) : n, n,
+                           [&value](T* first, T* last) { std::uninitialized_fill(first, last, value); });
+  }
+}
+
+// Returns to the inline buffer when the elements fit there again.
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::ShrinkToFit() {
+  if (IsInline() || size_ == capacity_) {
+    return;
+  }
+  if (size_ <= N) {
+    auto heap = data_;
+    auto heap_cap = capacity_;
+    detail::UninitializedRelocate(begin(), end(), InlineData());
+    AllocTraits::deallocate(alloc_, heap, heap_cap);
+    data_ = InlineData();
+    capacity_ = N;
+    return;
+  }
+  Reallocate(size_);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PushBack(const T& value) {
+  EmplaceBack(value);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PushBack(T&& value) {
+  EmplaceBack(std::move(value));
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+template <class... Args>
+void SmallVector<T, N, Allocator, GrowthPolicy>::EmplaceBack(Args&&... args) {
+  if (size_ < capacity_) {
+    new (end()) T(std::forward<Args>(args)...);
+    ++size_;
+    return;
+  }
+  ReallocateAndConstruct(GrowTo(size_ + 1), size_ + 1,
+                         [&args...](T* first, T*) { new (first) T(std::forward<Args>(args)...); });
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PopBack() noexcept {
+  size_--;
+  std::destroy_at(data_ + size_);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool operator==(const SmallVector<T, N, Allocator, GrowthPolicy>& vec1,
+                const SmallVector<T, N, Allocator, GrowthPolicy>& vec2) {
+  return detail::RangesEqual(vec1.Data(), vec1.Size(), vec2.Data(), vec2.Size());
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool operator!=(const SmallVector<T, N, Allocator, GrowthPolicy>& vec1,
+                const SmallVector<T, N, Allocator, GrowthPolicy>& vec2) {
+  return !(vec1 == vec2);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool operator<(const SmallVector<T, N, Allocator, GrowthPolicy>& vec1,
+               const SmallVector<T, N, Allocator, GrowthPolicy>& vec2) {
+  return detail::RangesLess(vec1.Data(), vec1.Size(), vec2.Data(), vec2.Size());
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool operator>(const SmallVector<T, N, Allocator, GrowthPolicy>& vec1,
+               const SmallVector<T, N, Allocator, GrowthPolicy>& vec2) {
+  return (vec2 < vec1);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool operator<=(const SmallVector<T, N, Allocator, GrowthPolicy>& vec1,
+                const SmallVector<T, N, Allocator, GrowthPolicy>& vec2) {
+  return !(vec2 < vec1);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+bool operator>=(const SmallVector<T, N, Allocator, GrowthPolicy>& vec1,
+                const SmallVector<T, N, Allocator, GrowthPolicy>& vec2) {
+  return !(vec1 < vec2);
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::Iterator
+SmallVector<T, N, Allocator, GrowthPolicy>::begin() noexcept {
+  return data_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::begin() const noexcept {
+  return data_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::cbegin() const noexcept {
+  return data_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::Iterator
+SmallVector<T, N, Allocator, GrowthPolicy>::end() noexcept {
+  return data_ + size_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::end() const noexcept {
+  return data_ + size_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::cend() const noexcept {
+  return data_ + size_;
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ReverseIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::rbegin() noexcept {
+  return ReverseIterator(end());
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstReverseIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::rbegin() const noexcept {
+  return ConstReverseIterator(cend());
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstReverseIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::crbegin() const noexcept {
+  return ConstReverseIterator(cend());
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ReverseIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::rend() noexcept {
+  return ReverseIterator(begin());
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstReverseIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::rend() const noexcept {
+  return ConstReverseIterator(cbegin());
+}
+
+template <class T, size_t N, class Allocator, class GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::ConstReverseIterator
+SmallVector<T, N, Allocator, GrowthPolicy>::crend() const noexcept {
+  return ConstReverseIterator(cbegin());
+}
@@ -0,0 +1,79 @@
+// Allocation count and time of Vector against SmallVector on many short-lived containers whose sizes are
+// mostly below the inline capacity.
+//
+//   g++ -std=c++20 -O2 small_vector_bench.cpp -o small_vector_bench && ./small_vector_bench
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+#include "small_vector.hpp"
+#include "vector.hpp"
+
+// std::allocator that counts the calls made through it.
+template <class T>
+struct CountingAllocator {
+  using value_type = T;  // NOLINT
+
+  static inline size_t allocations = 0;  // NOLINT
+  static inline size_t bytes = 0;        // NOLINT
+
+  CountingAllocator() noexcept = default;
+  template <class U>
+  CountingAllocator(const CountingAllocator<U>&) noexcept {  // NOLINT
+  }
+
+  T* allocate(size_t n) {  // NOLINT
+    ++allocations;
+    bytes += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* ptr, size_t n) noexcept {  // NOLINT
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  friend bool operator==(const CountingAllocator&, const CountingAllocator&) noexcept {
+    return true;
+  }
+};
+
+constexpr size_t kContainers = 1 << 20;
+constexpr size_t kInline = 8;
+
+// 7 out of 8 containers hold fewer than kInline elements, the rest up to 64.
+size_t SizeOf(uint64_t& state) {
+  state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+  auto r = state >> 33;
+  return r % 8 != 0 ? r / 8 % kInline : kInline + r / 8 % (64 - kInline);
+}
+
+template <class Container>
+void Run(const char* name) {
+  CountingAllocator<int>::allocations = 0;
+  CountingAllocator<int>::bytes = 0;
+  uint64_t state = 42;
+  uint64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < kContainers; ++i) {
+    Container c;
+    auto n = SizeOf(state);
+    for (size_t j = 0; j < n; ++j) {
+      c.PushBack(static_cast<int>(i + j));
+    }
+    for (auto x : c) {
+      checksum += static_cast<uint64_t>(x);
+    }
+  }
+  auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  std::printf("%-22s %9zu allocations (%.2f per container), %6.1f MB, %6.1f ms  [%llu]\n", name,
+              CountingAllocator<int>::allocations,
+              static_cast<double>(CountingAllocator<int>::allocations) / kContainers,
+              static_cast<double>(CountingAllocator<int>::bytes) / 1e6, ms,
+              static_cast<unsigned long long>(checksum));  // NOLINT
+}
+
+int main() {
+  Run<Vector<int, CountingAllocator<int>>>("Vector<int>");
+  Run<SmallVector<int, kInline, CountingAllocator<int>>>("SmallVector<int, 8>");
+}
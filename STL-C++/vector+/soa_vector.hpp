@@ -0,0 +1,516 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+
+// Structure-of-arrays container: row i of SoaVector<Ts...> is stored as one element in each of sizeof...(Ts)
+// contiguous columns, so a loop over one field only streams that field through the cache. All columns share the
+// size and the capacity and live in a single block, one 64-byte aligned column after another; growth reallocates
+// that block once. Rows are accessed through proxy tuples of references, columns through Data<I>().
+//
+// The growth policy comes first because the columns are a parameter pack; SoaVector<Ts...> uses DoublingGrowth,
+// like Vector. Grow() is given the size of a whole row as the element size.
+template <class GrowthPolicy, class... Ts>
+class BasicSoaVector {
+  static_assert(sizeof...(Ts) > 0, "SoaVector needs at least one column");
+  static_assert(((alignof(Ts) <= 64) && ...), "columns are aligned to 64 bytes");
+
+  static constexpr size_t kColumnAlignment = 64;
+  static constexpr size_t kRowBytes = (sizeof(Ts) + ...);
+  using Indices = std::index_sequence_for<Ts...>;
+  using Columns = std::tuple<Ts*...>;
+
+  std::byte* block_;
+  Columns columns_;
+  size_t size_;
+  size_t capacity_;
+
+ public:
+  template <size_t I>
+  using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+  using ValueType = std::tuple<Ts...>;
+  using Reference = std::tuple<Ts&...>;
+  using ConstReference = std::tuple<const Ts&...>;
+  using SizeType = size_t;
+
+  template <bool kConst>
+  class BasicIterator;
+  using Iterator = BasicIterator<false>;
+  using ConstIterator = BasicIterator<true>;
+
+  BasicSoaVector() noexcept;
+  explicit BasicSoaVector(size_t);
+  BasicSoaVector(const BasicSoaVector&);
+  BasicSoaVector(BasicSoaVector&&) noexcept;
+  BasicSoaVector& operator=(const BasicSoaVector&);
+  BasicSoaVector& operator=(BasicSoaVector&&) noexcept;
+  ~BasicSoaVector();
+
+  size_t Size() const noexcept;
+  size_t Capacity() const noexcept;
+  bool Empty() const noexcept;
+
+  Reference operator[](size_t) noexcept;
+  ConstReference operator[](size_t) const noexcept;
+  Reference At(size_t);
+  ConstReference At(size_t) const;
+  Reference Back() noexcept;
+  ConstReference Back() const noexcept;
+  template <size_t I>
+  ColumnType<I>* Data() noexcept;
+  template <size_t I>
+  const ColumnType<I>* Data() const noexcept;
+  template <size_t I>
+  std::span<ColumnType<I>> Column() noexcept;
+  template <size_t I>
+  std::span<const ColumnType<I>> Column() const noexcept;
+
+  void Swap(BasicSoaVector&) noexcept;
+  void Resize(size_t);
+  void Reserve(size_t);
+  void ShrinkToFit();
+  void Clear() noexcept;
+  template <class... Args>
+  void EmplaceBack(Args&&... args);
+  void PopBack() noexcept;
+
+  Iterator begin() noexcept;              // NOLINT
+  ConstIterator begin() const noexcept;   // NOLINT
+  ConstIterator cbegin() const noexcept;  // NOLINT
+  Iterator end() noexcept;                // NOLINT
+  ConstIterator end() const noexcept;     // NOLINT
+  ConstIterator cend() const noexcept;    // NOLINT
+
+ private:
+  static size_t BlockBytes(size_t cap);
+  static std::byte* AllocateBlock(size_t cap);
+  static void DeallocateBlock(std::byte* block) noexcept;
+  static Columns ColumnsOf(std::byte* block, size_t cap) noexcept;
+  template <class ColumnOp, size_t... Is>
+  static void ConstructRows(std::index_sequence<Is...>, const Columns&, size_t, size_t, ColumnOp);
+  template <size_t... Is>
+  static void DestroyRows(std::index_sequence<Is...>, const Columns&, size_t, size_t) noexcept;
+  template <size_t... Is>
+  static void RelocateRows(std::index_sequence<Is...>, const Columns&, const Columns&, size_t) noexcept;
+  template <class ColumnOp>
+  void ReallocateAndConstruct(size_t, size_t, ColumnOp);
+};
+
+template <class... Ts>
+using SoaVector = BasicSoaVector<DoublingGrowth, Ts...>;
+
+// Random access iterator over rows; dereferencing yields a tuple of references, so structured bindings in a
+// range-for modify the elements in place. The reference is a prvalue, which the Cpp17 forward iterator
+// requirements do not allow, so the legacy category is input and only the C++20 concept is random access.
+// ConstIterator satisfies std::random_access_iterator only with a library that gives std::tuple its C++23
+// common_reference (P2321, e.g. libstdc++ 13); before that tuple<const Ts&...> and tuple<Ts...>& have none.
+template <class GrowthPolicy, class... Ts>
+template <bool kConst>
+class BasicSoaVector<GrowthPolicy, Ts...>::BasicIterator {
+  using Owner = std::conditional_t<kConst, const BasicSoaVector, BasicSoaVector>;
+
+  Owner* owner_ = nullptr;
+  ptrdiff_t idx_ = 0;
+
+ public:
+  using iterator_category = std::input_iterator_tag;                        // NOLINT
+  using iterator_concept = std::random_access_iterator_tag;                  // NOLINT
+  using value_type = ValueType;                                              // NOLINT
+  using difference_type = ptrdiff_t;                                         // NOLINT
+  using reference = std::conditional_t<kConst, ConstReference, Reference>;  // NOLINT
+  using pointer = void;                                                      // NOLINT
+
+  BasicIterator() noexcept = default;
+  BasicIterator(Owner* owner, ptrdiff_t idx) noexcept : owner_(owner), idx_(idx) {
+  }
+  operator BasicIterator<true>() const noexcept requires(!kConst) {  // NOLINT
+    return {owner_, idx_};
+  }
+
+  reference operator*() const noexcept {
+    return (*owner_)[idx_];
+  }
+  reference operator[](ptrdiff_t n) const noexcept {
+    return (*owner_)[idx_ + n];
+  }
+
+  BasicIterator& operator++() noexcept {
+    ++idx_;
+    return *this;
+  }
+  BasicIterator operator++(int) noexcept {
+    return {owner_, idx_++};
+  }
+  BasicIterator& operator--() noexcept {
+    --idx_;
+    return *this;
+  }
+  BasicIterator operator--(int) noexcept {
+    return {owner_, idx_--};
+  }
+  BasicIterator& operator+=(ptrdiff_t n) noexcept {
+    idx_ += n;
+    return *this;
+  }
+  BasicIterator& operator-=(ptrdiff_t n) noexcept {
+    idx_ -= n;
+    return *this;
+  }
+
+  friend BasicIterator operator+(BasicIterator it, ptrdiff_t n) noexcept {
+    return it += n;
+  }
+  friend BasicIterator operator+(ptrdiff_t n, BasicIterator it) noexcept {
+    return it += n;
+  }
+  friend BasicIterator operator-(BasicIterator it, ptrdiff_t n) noexcept {
+    return it -= n;
+  }
+  friend ptrdiff_t operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+    return lhs.idx_ - rhs.idx_;
+  }
+  friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+    return lhs.idx_ == rhs.idx_;
+  }
+  friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+    return lhs.idx_ <=> rhs.idx_;
+  }
+};
+
+template <class GrowthPolicy, class... Ts>
+size_t BasicSoaVector<GrowthPolicy, Ts...>::BlockBytes(size_t cap) {
+  if (cap > (static_cast<size_t>(-1) - kColumnAlignment * sizeof...(Ts)) / kRowBytes) {
+    throw std::length_error("LengthError");
+  }
+  size_t bytes = 0;
+  ((bytes = (bytes + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment + cap * sizeof(Ts)), ...);
+  return bytes;
+}
+
+template <class GrowthPolicy, class... Ts>
+std::byte* BasicSoaVector<GrowthPolicy, Ts...>::AllocateBlock(size_t cap) {
+  if (cap == 0) {
+    return nullptr;
+  }
+  return static_cast<std::byte*>(::operator new(BlockBytes(cap), std::align_val_t{kColumnAlignment}));
+}
+
+template <class GrowthPolicy, class... Ts>
+void BasicSoaVector<GrowthPolicy, Ts...>::DeallocateBlock(std::byte* block) noexcept {
+  if (block) {
+    ::operator delete(block, std::align_val_t{kColumnAlignment});
+  }
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::Columns
+BasicSoaVector<GrowthPolicy, Ts...>::ColumnsOf(std::byte* block, size_t cap) noexcept {
+  if (!block) {
+    return Columns{};
+  }
+  size_t offset = 0;
+  auto next = [block, cap, &offset](size_t size) {
+    auto column = block + offset;
+    offset = (offset + cap * size + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+    return column;
+  };
+  // Elements of a braced list are evaluated left to right, so the columns come out in order.
+  return Columns{reinterpret_cast<Ts*>(next(sizeof(Ts)))...};
+}
+
+// Runs op(std::integral_constant<size_t, I>, column + first, column + last) for every column I. op must behave
+// like the std::uninitialized_* algorithms; if it throws, the columns already filled are destroyed again.
+template <class GrowthPolicy, class... Ts>
+template <class ColumnOp, size_t... Is>
+void BasicSoaVector<GrowthPolicy, Ts...>::ConstructRows(std::index_sequence<Is...>, const Columns& columns,
+                                                        size_t first, size_t last, ColumnOp op) {
+  size_t built = 0;
+  try {
+    ((op(std::integral_constant<size_t, Is>{}, std::get<Is>(columns) + first, std::get<Is>(columns) + last),
+      ++built),
+     ...);
+  } catch (...) {
+    ((Is < built ? std::destroy(std::get<Is>(columns) + first, std::get<Is>(columns) + last) : void()), ...);
+    throw;
+  }
+}
+
+template <class GrowthPolicy, class... Ts>
+template <size_t... Is>
+void BasicSoaVector<GrowthPolicy, Ts...>::DestroyRows(std::index_sequence<Is...>, const Columns& columns, size_t first,
+                                                      size_t last) noexcept {
+  (std::destroy(std::get<Is>(columns) + first, std::get<Is>(columns) + last), ...);
+}
+
+template <class GrowthPolicy, class... Ts>
+template <size_t... Is>
+void BasicSoaVector<GrowthPolicy, Ts...>::RelocateRows(std::index_sequence<Is...>, const Columns& from,
+                                                       const Columns& to, size_t n) noexcept {
+  (detail::UninitializedRelocate(std::get<Is>(from), std::get<Is>(from) + n, std::get<Is>(to)), ...);
+}
+
+// Builds rows [size_, new_size) in a new block of new_cap rows with op, as ConstructRows does, and only then
+// relocates the existing rows, so a throwing constructor leaves the vector unchanged.
+template <class GrowthPolicy, class... Ts>
+template <class ColumnOp>
+void BasicSoaVector<GrowthPolicy, Ts...>::ReallocateAndConstruct(size_t new_cap, size_t new_size, ColumnOp op) {
+  auto block = AllocateBlock(new_cap);
+  auto columns = ColumnsOf(block, new_cap);
+  try {
+    ConstructRows(Indices{}, columns, size_, new_size, op);
+  } catch (...) {
+    DeallocateBlock(block);
+    throw;
+  }
+  RelocateRows(Indices{}, columns_, columns, size_);
+  DeallocateBlock(block_);
+  block_ = block;
+  columns_ = columns;
+  capacity_ = new_cap;
+  size_ = new_size;
+}
+
+template <class GrowthPolicy, class... Ts>
+BasicSoaVector<GrowthPolicy, Ts...>::BasicSoaVector() noexcept : block_(nullptr), columns_(), size_(0), capacity_(0) {
+}
+
+template <class GrowthPolicy, class... Ts>
+BasicSoaVector<GrowthPolicy, Ts...>::BasicSoaVector(size_t n) : BasicSoaVector() {
+  Resize(n);
+}
+
+template <class GrowthPolicy, class... Ts>
+BasicSoaVector<GrowthPolicy, Ts...>::BasicSoaVector(const BasicSoaVector& other) : BasicSoaVector() {
+  ReallocateAndConstruct(other.size_, other.size_, [&other](auto index, auto first, auto last) {
+    auto source = std::get<decltype(index)::value>(other.columns_);
+    std::uninitialized_copy(source, source + (last - first), first);
+  });
+}
+
+template <class GrowthPolicy, class... Ts>
+BasicSoaVector<GrowthPolicy, Ts...>::BasicSoaVector(BasicSoaVector&& other) noexcept
+    : block_(other.block_), columns_(other.columns_), size_(other.size_), capacity_(other.capacity_) {
+  other.block_ = nullptr;
+  other.columns_ = Columns{};
+  other.size_ = 0;
+  other.capacity_ = 0;
+}
+
+template <class GrowthPolicy, class... Ts>
+BasicSoaVector<GrowthPolicy, Ts...>& BasicSoaVector<GrowthPolicy, Ts...>::operator=(const BasicSoaVector& other) {
+  if (this != &other) {
+    BasicSoaVector tmp(other);
+    Swap(tmp);
+  }
+  return *this;
+}
+
+template <class GrowthPolicy, class... Ts>
+BasicSoaVector<GrowthPolicy, Ts...>& BasicSoaVector<GrowthPolicy, Ts...>::operator=(BasicSoaVector&& other) noexcept {
+  if (this != &other) {
+    BasicSoaVector tmp(std::move(other));
+    Swap(tmp);
+  }
+  return *this;
+}
+
+template <class GrowthPolicy, class... Ts>
+BasicSoaVector<GrowthPolicy, Ts...>::~BasicSoaVector() {
+  DestroyRows(Indices{}, columns_, 0, size_);
+  DeallocateBlock(block_);
+}
+
+template <class GrowthPolicy, class... Ts>
+size_t BasicSoaVector<GrowthPolicy, Ts...>::Size() const noexcept {
+  return size_;
+}
+
+template <class GrowthPolicy, class... Ts>
+size_t BasicSoaVector<GrowthPolicy, Ts...>::Capacity() const noexcept {
+  return capacity_;
+}
+
+template <class GrowthPolicy, class... Ts>
+bool BasicSoaVector<GrowthPolicy, Ts...>::Empty() const noexcept {
+  return size_ == 0;
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::Reference
+BasicSoaVector<GrowthPolicy, Ts...>::operator[](size_t idx) noexcept {
+  return std::apply([idx](Ts*... columns) { return Reference(columns[idx]...); }, columns_);
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::ConstReference
+BasicSoaVector<GrowthPolicy, Ts...>::operator[](size_t idx) const noexcept {
+  return std::apply([idx](Ts*... columns) { return ConstReference(columns[idx]...); }, columns_);
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::Reference
+BasicSoaVector<GrowthPolicy, Ts...>::At(size_t idx) {
+  if (idx >= size_) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return (*this)[idx];
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::ConstReference
+BasicSoaVector<GrowthPolicy, Ts...>::At(size_t idx) const {
+  if (idx >= size_) {
+    throw std::out_of_range("OutOfRange");
+  }
+  return (*this)[idx];
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::Reference
+BasicSoaVector<GrowthPolicy, Ts...>::Back() noexcept {
+  return (*this)[size_ - 1];
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::ConstReference
+BasicSoaVector<GrowthPolicy, Ts...>::Back() const noexcept {
+  return (*this)[size_ - 1];
+}
+
+template <class GrowthPolicy, class... Ts>
+template <size_t I>
+typename BasicSoaVector<GrowthPolicy, Ts...>::template ColumnType<I>*
+BasicSoaVector<GrowthPolicy, Ts...>::Data() noexcept {
+  return std::get<I>(columns_);
+}
+
+template <class GrowthPolicy, class... Ts>
+template <size_t I>
+const typename BasicSoaVector<GrowthPolicy, Ts...>::template ColumnType<I>*
+BasicSoaVector<GrowthPolicy, Ts...>::Data() const noexcept {
+  return std::get<I>(columns_);
+}
+
+template <class GrowthPolicy, class... Ts>
+template <size_t I>
+std::span<typename BasicSoaVector<GrowthPolicy, Ts...>::template ColumnType<I>>
+BasicSoaVector<GrowthPolicy, Ts...>::Column() noexcept {
+  return {Data<I>(), size_};
+}
+
+template <class GrowthPolicy, class... Ts>
+template <size_t I>
+std::span<const typename BasicSoaVector<GrowthPolicy, Ts...>::template ColumnType<I>>
+BasicSoaVector<GrowthPolicy, Ts...>::Column() const noexcept {
+  return {Data<I>(), size_};
+}
+
+template <class GrowthPolicy, class... Ts>
+void BasicSoaVector<GrowthPolicy, Ts...>::Swap(BasicSoaVector& other) noexcept {
+  std::swap(block_, other.block_);
+  std::swap(columns_, other.columns_);
+  std::swap(size_, other.size_);
+  std::swap(capacity_, other.capacity_);
+}
+
+template <class GrowthPolicy, class... Ts>
+void BasicSoaVector<GrowthPolicy, Ts...>::Resize(size_t n) {
+  auto construct = [](auto, auto first, auto last) { std::uninitialized_default_construct(first, last); };
+  if (n <= size_) {
+    DestroyRows(Indices{}, columns_, n, size_);
+  } else if (n <= capacity_) {
+    ConstructRows(Indices{}, columns_, size_, n, construct);
+  } else {
+    ReallocateAndConstruct(GrowthPolicy::kAmortizedResize ? GrowthPolicy::Grow(size_, n, kRowBytes) : n, n, construct);
+  }
+  size_ = n;
+}
+
+template <class GrowthPolicy, class... Ts>
+void BasicSoaVector<GrowthPolicy, Ts...>::Reserve(size_t new_cap) {
+  if (new_cap > capacity_) {
+    ReallocateAndConstruct(new_cap, size_, [](auto, auto, auto) {});
+  }
+}
+
+template <class GrowthPolicy, class... Ts>
+void BasicSoaVector<GrowthPolicy, Ts...>::ShrinkToFit() {
+  if (size_ < capacity_) {
+    ReallocateAndConstruct(size_, size_, [](auto, auto, auto) {});
+  }
+}
+
+template <class GrowthPolicy, class... Ts>
+void BasicSoaVector<GrowthPolicy, Ts...>::Clear() noexcept {
+  DestroyRows(Indices{}, columns_, 0, size_);
+  size_ = 0;
+}
+
+// Appends a row built from one argument per column; args may refer into the vector itself.
+template <class GrowthPolicy, class... Ts>
+template <class... Args>
+void BasicSoaVector<GrowthPolicy, Ts...>::EmplaceBack(Args&&... args) {
+  static_assert(sizeof...(Args) == sizeof...(Ts), "EmplaceBack takes one argument per column");
+  auto fields = std::forward_as_tuple(std::forward<Args>(args)...);
+  auto construct = [&fields](auto index, auto first, auto) {
+    using Field = std::remove_pointer_t<decltype(first)>;
+    new (first) Field(std::get<decltype(index)::value>(std::move(fields)));
+  };
+  if (size_ < capacity_) {
+    ConstructRows(Indices{}, columns_, size_, size_ + 1, construct);
+    ++size_;
+  } else {
+    ReallocateAndConstruct(GrowthPolicy::Grow(size_, size_ + 1, kRowBytes), size_ + 1, construct);
+  }
+}
+
+template <class GrowthPolicy, class... Ts>
+void BasicSoaVector<GrowthPolicy, Ts...>::PopBack() noexcept {
+  --size_;
+  DestroyRows(Indices{}, columns_, size_, size_ + 1);
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::Iterator
+BasicSoaVector<GrowthPolicy, Ts...>::begin() noexcept {
+  return {this, 0};
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::ConstIterator
+BasicSoaVector<GrowthPolicy, Ts...>::begin() const noexcept {
+  return {this, 0};
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::ConstIterator
+BasicSoaVector<GrowthPolicy, Ts...>::cbegin() const noexcept {
+  return {this, 0};
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::Iterator
+BasicSoaVector<GrowthPolicy, Ts...>::end() noexcept {
+  return {this, static_cast<ptrdiff_t>(size_)};
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::ConstIterator
+BasicSoaVector<GrowthPolicy, Ts...>::end() const noexcept {
+  return {this, static_cast<ptrdiff_t>(size_)};
+}
+
+template <class GrowthPolicy, class... Ts>
+typename BasicSoaVector<GrowthPolicy, Ts...>::ConstIterator
+BasicSoaVector<GrowthPolicy, Ts...>::cend() const noexcept {
+  return {this, static_cast<ptrdiff_t>(size_)};
+}
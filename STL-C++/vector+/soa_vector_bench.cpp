@@ -0,0 +1,109 @@
+// Field scans over an array of 64-byte records, stored as Vector<Record> (array of structures) and as
+// SoaVector with one column per field.
+//
+//   g++ -std=c++20 -O2 -march=native soa_vector_bench.cpp -o soa_vector_bench && ./soa_vector_bench [rows]
+//
+// One-field and two-field scans touch 1/8 and 1/4 of each record; the full-row scan reads every field, so
+// there the layouts move the same number of bytes.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "soa_vector.hpp"
+#include "vector.hpp"
+
+struct Record {
+  double x;
+  double y;
+  double z;
+  double vx;
+  double vy;
+  double vz;
+  double mass;
+  int64_t id;
+};
+
+using Columns = SoaVector<double, double, double, double, double, double, double, int64_t>;
+
+constexpr int kRepetitions = 10;
+
+template <class F>
+double BestMillis(F f) {
+  auto best = 1e30;
+  for (int rep = 0; rep < kRepetitions; ++rep) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+  return best;
+}
+
+// Keeps the compiler from dropping a scan whose result is unused.
+volatile double sink;
+
+int main(int argc, char** argv) {
+  size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{1} << 23;
+  Vector<Record> aos;
+  Columns soa;
+  aos.Reserve(rows);
+  soa.Reserve(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    auto v = static_cast<double>(i % 1000);
+    aos.PushBack({v, v + 1, v + 2, 1, 2, 3, v * 0.5, static_cast<int64_t>(i)});
+    soa.EmplaceBack(v, v + 1, v + 2, 1.0, 2.0, 3.0, v * 0.5, static_cast<int64_t>(i));
+  }
+
+  auto aos_one = BestMillis([&] {
+    double total = 0;
+    for (const auto& r : aos) {
+      total += r.mass;
+    }
+    sink = total;
+  });
+  auto soa_one = BestMillis([&] {
+    double total = 0;
+    auto mass = soa.Data<6>();
+    for (size_t i = 0; i < rows; ++i) {
+      total += mass[i];
+    }
+    sink = total;
+  });
+  auto aos_two = BestMillis([&] {
+    double total = 0;
+    for (const auto& r : aos) {
+      total += r.x * r.mass;
+    }
+    sink = total;
+  });
+  auto soa_two = BestMillis([&] {
+    double total = 0;
+    auto x = soa.Data<0>();
+    auto mass = soa.Data<6>();
+    for (size_t i = 0; i < rows; ++i) {
+      total += x[i] * mass[i];
+    }
+    sink = total;
+  });
+  auto aos_all = BestMillis([&] {
+    double total = 0;
+    for (const auto& r : aos) {
+      total += r.x + r.y + r.z + r.vx + r.vy + r.vz + r.mass + static_cast<double>(r.id);
+    }
+    sink = total;
+  });
+  auto soa_all = BestMillis([&] {
+    double total = 0;
+    for (auto [x, y, z, vx, vy, vz, mass, id] : soa) {
+      total += x + y + z + vx + vy + vz + mass + static_cast<double>(id);
+    }
+    sink = total;
+  });
+
+  std::printf("%zu rows of %zu bytes, best of %d\n", rows, sizeof(Record), kRepetitions);
+  std::printf("sum(mass)        AoS %7.2f ms  SoA %7.2f ms  %5.2fx\n", aos_one, soa_one, aos_one / soa_one);
+  std::printf("sum(x * mass)    AoS %7.2f ms  SoA %7.2f ms  %5.2fx\n", aos_two, soa_two, aos_two / soa_two);
+  std::printf("sum(all fields)  AoS %7.2f ms  SoA %7.2f ms  %5.2fx\n", aos_all, soa_all, aos_all / soa_all);
+}
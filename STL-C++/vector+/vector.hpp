@@ -3,44 +3,364 @@
 #define VECTOR_MEMORY_IMPLEMENTED
 
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstring>
 #include <exception>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define VECTOR_HAS_AVX2_KERNELS
+#endif
+
+// Types whose objects may be moved to another address by copying their bytes, without calling the move
+// constructor and the destructor. Specialize for types like structs owning std::unique_ptr.
+template <class T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <class T>
+constexpr inline bool kIsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Types whose operator== is equivalent to comparing object representations, so that ranges of them may be
+// compared with memcmp. Floating point types are excluded (0.0 == -0.0, NaN != NaN); specialize for
+// padding-free structs with member-wise operator==.
+template <class T>
+struct IsTriviallyEqualityComparable
+    : std::bool_constant<std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>> {};
+
+template <class T>
+constexpr inline bool kIsTriviallyEqualityComparableV = IsTriviallyEqualityComparable<T>::value;
+
+// Growth policies: Grow(size, required, sizeof(T)) returns the capacity to reallocate to when required
+// elements no longer fit into the buffer holding size of them. Vector calls it from every amortized growth site
+// (PushBack, EmplaceBack, Insert, Append) and, if kAmortizedResize is set, from Resize as well. Reserve and
+// ShrinkToFit always allocate exactly what was asked.
+
+// The multiplicative scheme with factor 2; Resize allocates exactly new_size as the task requires.
+struct DoublingGrowth {
+  static constexpr bool kAmortizedResize = false;
+
+  static constexpr size_t Grow(size_t size, size_t required, size_t /*element_size*/) noexcept {
+    return std::max(size == 0 ? 2 : size * 2, required);
+  }
+};
+
+// Factor 1.5, which lets freed blocks be reused by later growth steps.
+struct GoldenGrowth {
+  static constexpr bool kAmortizedResize = true;
+
+  static constexpr size_t Grow(size_t size, size_t required, size_t /*element_size*/) noexcept {
+    return std::max(size < 2 ? 2 : size + size / 2, required);
+  }
+};
+
+// Factor 1.5 rounded up to the malloc size classes (16-byte steps up to 128 bytes, then four classes per power
+// of two), so the slack the allocator would waste anyway becomes usable capacity.
+struct SizeClassGrowth {
+  static constexpr bool kAmortizedResize = true;
+
+  static constexpr size_t Grow(size_t size, size_t required, size_t element_size) noexcept {
+    auto wanted = GoldenGrowth::Grow(size, required, element_size);
+    auto bytes = wanted * element_size;
+    auto step = bytes <= 128 ? size_t{16} : std::bit_floor(bytes - 1) / 4;
+    return std::max(wanted, (bytes + step - 1) / step * step / element_size);
+  }
+};
+
+// Optional per-element-type growth statistics, collected when VECTOR_COLLECT_STATS is defined: how many times
+// vectors of T reallocated, how many bytes of elements that moved, and the largest capacity reached. Types
+// with many reallocations and a known final size are candidates for Reserve.
+template <class T>
+struct VectorStats {
+  static inline std::atomic<size_t> reallocations{0};  // NOLINT
+  static inline std::atomic<size_t> bytes_moved{0};    // NOLINT
+  static inline std::atomic<size_t> peak_capacity{0};  // NOLINT
+
+  static void Record(size_t moved_elements, size_t new_cap) noexcept {
+    reallocations.fetch_add(1, std::memory_order_relaxed);
+    bytes_moved.fetch_add(moved_elements * sizeof(T), std::memory_order_relaxed);
+    auto peak = peak_capacity.load(std::memory_order_relaxed);
+    while (peak < new_cap && !peak_capacity.compare_exchange_weak(peak, new_cap, std::memory_order_relaxed)) {
+    }
+  }
+
+  static void Reset() noexcept {
+    reallocations = 0;
+    bytes_moved = 0;
+    peak_capacity = 0;
+  }
+};
+
+// Opt-in tag for the bulk fill and copy operations: the range is split into chunks of at least min_chunk_bytes
+// that are constructed by up to threads threads. Besides using more than one core's bandwidth, each thread
+// first-touches its own pages, so under the default NUMA policy a huge buffer is spread over the nodes.
+struct ParallelConstruction {
+  size_t threads = std::thread::hardware_concurrency();
+  size_t min_chunk_bytes = size_t{64} << 20;
+};
 
 namespace detail {
 template <class Iterator>
 using EnifForwardIt = std::enable_if_t<
     std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>, int>;
-}
 
+// Moves [first, last) to uninitialized dest and ends the lifetime of the source objects.
 template <class T>
-class Vector;
+void UninitializedRelocate(T* first, T* last, T* dest) noexcept {
+  if constexpr (kIsTriviallyRelocatableV<T>) {
+    if (first != last) {
+      std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first),
+                  static_cast<size_t>(last - first) * sizeof(T));
+    }
+  } else {
+    std::uninitialized_move(first, last, dest);
+    std::destroy(first, last);
+  }
+}
 
-template <class T>
-bool operator==(const Vector<T>&, const Vector<T>&);
+// Allocators that can resize a buffer without copying it (e.g. with mremap) provide
+// T* reallocate(T* ptr, size_t old_n, size_t new_n, size_t used), which keeps the first used elements. It is
+// only applicable to trivially relocatable T, whose bytes may be moved by the kernel.
+template <class Allocator, class T>
+constexpr inline bool kReallocatesInPlaceV =
+    kIsTriviallyRelocatableV<T> && requires(Allocator& alloc, T* ptr, size_t n) {
+      { alloc.reallocate(ptr, n, n, n) } -> std::same_as<T*>;
+    };
 
+// Relocates [first, last) to dest inside the same buffer, where the two ranges may overlap.
 template <class T>
-bool operator!=(const Vector<T>&, const Vector<T>&);
+void UninitializedRelocateWithin(T* first, T* last, T* dest) noexcept {
+  if constexpr (kIsTriviallyRelocatableV<T>) {
+    if (first != last) {
+      std::memmove(static_cast<void*>(dest), static_cast<const void*>(first),
+                   static_cast<size_t>(last - first) * sizeof(T));
+    }
+  } else if (dest < first) {
+    for (; first != last; ++first, ++dest) {
+      new (dest) T(std::move(*first));
+      std::destroy_at(first);
+    }
+  } else if (dest > first) {
+    dest += last - first;
+    while (first != last) {
+      new (--dest) T(std::move(*--last));
+      std::destroy_at(last);
+    }
+  }
+}
 
-template <class T>
-bool operator<=(const Vector<T>&, const Vector<T>&);
+// Allocates new_cap elements, constructs count new ones at index pos there and only then relocates
+// [data, data + size) around them, so a throwing constructor leaves the source untouched. The old buffer is
+// not released.
+template <class Allocator, class T, class Construct>
+T* RelocatingGrow(Allocator& alloc, T* data, size_t size, size_t new_cap, size_t pos, size_t count,
+                  Construct construct) {
+  using AllocTraits = std::allocator_traits<Allocator>;
+  auto new_data = AllocTraits::allocate(alloc, new_cap);
+  try {
+    construct(new_data + pos, new_data + pos + count);
+  } catch (...) {
+    AllocTraits::deallocate(alloc, new_data, new_cap);
+    throw;
+  }
+  UninitializedRelocate(data, data + pos, new_data);
+  UninitializedRelocate(data + pos, data + size, new_data + pos + count);
+  return new_data;
+}
 
-template <class T>
-bool operator>=(const Vector<T>&, const Vector<T>&);
+// Runs construct(first, last) over chunks of [data, data + n) in parallel. Each call must construct its whole
+// chunk or throw leaving nothing behind; if any of them throws, the chunks that succeeded are destroyed and
+// the first exception is rethrown, so the range is left as uninitialized as it was.
+template <class T, class Construct>
+void ParallelConstruct(const ParallelConstruction& policy, T* data, size_t n, Construct construct) {
+  auto max_chunks = n * sizeof(T) / std::max(policy.min_chunk_bytes, size_t{1});
+  auto chunks = std::min(std::max(policy.threads, size_t{1}), std::max(max_chunks, size_t{1}));
+  if (chunks <= 1) {
+    construct(data, data + n);
+    return;
+  }
+  auto bounds = [data, n, chunks](size_t i) { return data + n / chunks * i + std::min(i, n % chunks); };
+  auto errors = std::make_unique<std::exception_ptr[]>(chunks);
+  auto run = [&](size_t i) {
+    try {
+      construct(bounds(i), bounds(i + 1));
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+  auto workers = std::make_unique<std::thread[]>(chunks);
+  for (size_t i = 1; i < chunks; ++i) {
+    // Starting a thread can fail with system_error or, allocating its state, bad_alloc. Either way the chunk
+    // is constructed on this thread instead, so the workers already running are always joined below.
+    try {
+      workers[i] = std::thread(run, i);
+    } catch (...) {
+      run(i);
+    }
+  }
+  run(0);
+  for (size_t i = 1; i < chunks; ++i) {
+    if (workers[i].joinable()) {
+      workers[i].join();
+    }
+  }
+  std::exception_ptr error;
+  for (size_t i = 0; i < chunks; ++i) {
+    if (errors[i]) {
+      error = error ? error : errors[i];
+    }
+  }
+  if (error) {
+    for (size_t i = 0; i < chunks; ++i) {
+      if (!errors[i]) {
+        std::destroy(bounds(i), bounds(i + 1));
+      }
+    }
+    std::rethrow_exception(error);
+  }
+}
 
+// Byte types whose lexicographic order is exactly the one of memcmp.
 template <class T>
-bool operator<(const Vector<T>&, const Vector<T>&);
+constexpr inline bool kIsUnsignedByteV = std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte> ||
+                                         std::is_same_v<T, char8_t> ||
+                                         (std::is_same_v<T, char> && std::is_unsigned_v<char>);
+
+// Index of the first differing byte of a and b, or n if they are equal.
+inline size_t FirstMismatchScalar(const unsigned char* a, const unsigned char* b, size_t n) noexcept {
+  size_t i = 0;
+  if constexpr (std::endian::native == std::endian::little) {
+    for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+      uint64_t x;
+      uint64_t y;
+      std::memcpy(&x, a + i, sizeof(x));
+      std::memcpy(&y, b + i, sizeof(y));
+      if (x != y) {
+        return i + static_cast<size_t>(std::countr_zero(x ^ y)) / 8;
+      }
+    }
+  }
+  while (i < n && a[i] == b[i]) {
+    ++i;
+  }
+  return i;
+}
+
+#ifdef VECTOR_HAS_AVX2_KERNELS
+__attribute__((target("avx2"))) inline size_t FirstMismatchAvx2(const unsigned char* a, const unsigned char* b,
+                                                                size_t n) noexcept {
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= n; i += sizeof(__m256i)) {
+    auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    auto equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    if (equal != 0xFFFFFFFFu) {
+      return i + static_cast<size_t>(std::countr_zero(~equal));
+    }
+  }
+  return i + FirstMismatchScalar(a + i, b + i, n - i);
+}
+#endif
+
+inline size_t FirstMismatch(const void* a, const void* b, size_t n) noexcept {
+  auto x = static_cast<const unsigned char*>(a);
+  auto y = static_cast<const unsigned char*>(b);
+#ifdef VECTOR_HAS_AVX2_KERNELS
+  static const bool kHasAvx2 = __builtin_cpu_supports("avx2");
+  if (kHasAvx2) {
+    return FirstMismatchAvx2(x, y, n);
+  }
+#endif
+  return FirstMismatchScalar(x, y, n);
+}
 
 template <class T>
-bool operator>(const Vector<T>&, const Vector<T>&);
+bool RangesEqual(const T* first1, size_t size1, const T* first2, size_t size2) {
+  if (size1 != size2) {
+    return false;
+  }
+  if constexpr (kIsTriviallyEqualityComparableV<T>) {
+    return size1 == 0 || std::memcmp(first1, first2, size1 * sizeof(T)) == 0;
+  } else {
+    for (size_t i = 0; i < size1; ++i) {
+      if (first1[i] != first2[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
 
+// Trivially equality comparable ranges are scanned bytewise for the first differing element, which then
+// decides the order; unsigned bytes are ordered by memcmp directly.
 template <class T>
+bool RangesLess(const T* first1, size_t size1, const T* first2, size_t size2) {
+  auto common = std::min(size1, size2);
+  if constexpr (kIsUnsignedByteV<T>) {
+    auto cmp = common == 0 ? 0 : std::memcmp(first1, first2, common);
+    return cmp != 0 ? cmp < 0 : size1 < size2;
+  } else if constexpr (kIsTriviallyEqualityComparableV<T>) {
+    auto i = FirstMismatch(first1, first2, common * sizeof(T)) / sizeof(T);
+    return i < common ? first1[i] < first2[i] : size1 < size2;
+  } else {
+    for (size_t i = 0; i < common; ++i) {
+      if (first1[i] < first2[i]) {
+        return true;
+      }
+      if (first2[i] < first1[i]) {
+        return false;
+      }
+    }
+    return (size1 < size2);
+  }
+}
+}  // namespace detail
+
+template <class T, class Allocator = std::allocator<T>, class GrowthPolicy = DoublingGrowth>
+class Vector;
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator==(const Vector<T, Allocator, GrowthPolicy>&, const Vector<T, Allocator, GrowthPolicy>&);
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator!=(const Vector<T, Allocator, GrowthPolicy>&, const Vector<T, Allocator, GrowthPolicy>&);
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator<=(const Vector<T, Allocator, GrowthPolicy>&, const Vector<T, Allocator, GrowthPolicy>&);
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator>=(const Vector<T, Allocator, GrowthPolicy>&, const Vector<T, Allocator, GrowthPolicy>&);
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator<(const Vector<T, Allocator, GrowthPolicy>&, const Vector<T, Allocator, GrowthPolicy>&);
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator>(const Vector<T, Allocator, GrowthPolicy>&, const Vector<T, Allocator, GrowthPolicy>&);
+
+// The allocator only supplies raw storage; elements are still created with placement new and destroyed
+// explicitly, so relocation may bypass the allocator's construct/destroy.
+template <class T, class Allocator, class GrowthPolicy>
 class Vector {
  private:
-  std::byte* data_;
+  using AllocTraits = std::allocator_traits<Allocator>;
+  static_assert(std::is_same_v<typename AllocTraits::value_type, T>, "Allocator::value_type must be T");
+  static_assert(std::is_same_v<typename AllocTraits::pointer, T*>, "fancy pointers are not supported");
+  static constexpr bool kReallocatesInPlace = detail::kReallocatesInPlaceV<Allocator, T>;
+
+  T* data_;
   size_t size_;
   size_t capacity_;
+  [[no_unique_address]] Allocator alloc_;
 
  public:
   using Iterator = T*;
@@ -48,25 +368,34 @@ class Vector {
   using ReverseIterator = std::reverse_iterator<T*>;
   using ConstReverseIterator = std::reverse_iterator<const T*>;
   using ValueType = T;
+  using AllocatorType = Allocator;
   using Pointer = T*;
   using ConstPointer = const T*;
   using Reference = T&;
   using ConstReference = const T&;
   using SizeType = size_t;
 
-  Vector() noexcept;
-  explicit Vector(size_t);
-  Vector(size_t, const T&);
-  Vector(std::initializer_list<T>);
+  Vector() noexcept(noexcept(Allocator()));
+  explicit Vector(const Allocator&) noexcept;
+  explicit Vector(size_t, const Allocator& = Allocator());
+  Vector(size_t, const T&, const Allocator& = Allocator());
+  Vector(const ParallelConstruction&, size_t, const T&, const Allocator& = Allocator());
+  Vector(std::initializer_list<T>, const Allocator& = Allocator());
   template <class ForwardIt, detail::EnifForwardIt<ForwardIt> = 0>
-  Vector(ForwardIt, ForwardIt);
-
-  Vector(const Vector<T>&);
-  Vector(Vector<T>&&) noexcept;
-  Vector& operator=(const Vector<T>&);
-  Vector& operator=(Vector<T>&&) noexcept;
+  Vector(ForwardIt, ForwardIt, const Allocator& = Allocator());
+
+  Vector(const Vector&);
+  Vector(const Vector&, const Allocator&);
+  Vector(const ParallelConstruction&, const Vector&);
+  Vector(Vector&&) noexcept;
+  Vector(Vector&&, const Allocator&);
+  Vector& operator=(const Vector&);
+  Vector& operator=(Vector&&) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                       AllocTraits::is_always_equal::value);
   ~Vector();
 
+  Allocator GetAllocator() const noexcept;
+
   size_t Size() const noexcept;
   size_t Capacity() const noexcept;
   bool Empty() const noexcept;
@@ -82,9 +411,12 @@ class Vector {
   T* Data() noexcept;
   const T* Data() const noexcept;
 
-  void Swap(Vector<T>&) noexcept;
+  void Swap(Vector&) noexcept;
   void Resize(size_t);
   void Resize(size_t, const T&);
+  void Resize(const ParallelConstruction&, size_t, const T&);
+  void ResizeForOverwrite(size_t);
+  std::span<T> AppendUninitialized(size_t);
   void Reserve(size_t);
   void ShrinkToFit();
   void Clear() noexcept;
@@ -94,6 +426,16 @@ class Vector {
   void EmplaceBack(Args&&... args);
   void PopBack() noexcept;
 
+  Iterator Insert(ConstIterator, const T&);
+  Iterator Insert(ConstIterator, T&&);
+  Iterator Insert(ConstIterator, size_t, const T&);
+  template <class ForwardIt, detail::EnifForwardIt<ForwardIt> = 0>
+  Iterator Insert(ConstIterator, ForwardIt, ForwardIt);
+  template <class ForwardIt, detail::EnifForwardIt<ForwardIt> = 0>
+  void Append(ForwardIt, ForwardIt);
+  Iterator Erase(ConstIterator) noexcept;
+  Iterator Erase(ConstIterator, ConstIterator) noexcept;
+
   Iterator begin() noexcept;                      // NOLINT
   ConstIterator begin() const noexcept;           // NOLINT
   ConstIterator cbegin() const noexcept;          // NOLINT
@@ -107,587 +449,669 @@ class Vector {
   ConstReverseIterator rend() const noexcept;     // NOLINT
   ConstReverseIterator crend() const noexcept;    // NOLINT
 
-  friend bool operator== <T>(const Vector<T>&, const Vector<T>&);
-  friend bool operator!= <T>(const Vector<T>&, const Vector<T>&);
-  friend bool operator<= <T>(const Vector<T>&, const Vector<T>&);
-  friend bool operator>= <T>(const Vector<T>&, const Vector<T>&);
-  friend bool operator< <T>(const Vector<T>&, const Vector<T>&);
-  friend bool operator><T>(const Vector<T>&, const Vector<T>&);
+  friend bool operator== <T, Allocator, GrowthPolicy>(const Vector&, const Vector&);
+  friend bool operator!= <T, Allocator, GrowthPolicy>(const Vector&, const Vector&);
+  friend bool operator<= <T, Allocator, GrowthPolicy>(const Vector&, const Vector&);
+  friend bool operator>= <T, Allocator, GrowthPolicy>(const Vector&, const Vector&);
+  friend bool operator< <T, Allocator, GrowthPolicy>(const Vector&, const Vector&);
+  friend bool operator><T, Allocator, GrowthPolicy>(const Vector&, const Vector&);
+
+ private:
+  T* Allocate(size_t);
+  void Deallocate() noexcept;
+  template <class Construct>
+  void ConstructWith(size_t, size_t, Construct);
+  void StealFrom(Vector&) noexcept;
+  void Reallocate(size_t);
+  template <class Construct>
+  void ReallocateAndConstruct(size_t, size_t, Construct);
+  template <class Construct>
+  Iterator InsertWith(size_t, size_t, Construct);
+  template <class Fill>
+  void ResizeWith(size_t, const T&, Fill);
+  bool Owns(const T*) const noexcept;
+  size_t GrowTo(size_t) const noexcept;
+  void NoteReallocation(size_t) const noexcept;
 };
 
-template <class T>
-Vector<T>::Vector() noexcept : data_(nullptr), size_(0), capacity_(size_) {
+template <class T, class Allocator, class GrowthPolicy>
+T* Vector<T, Allocator, GrowthPolicy>::Allocate(size_t n) {
+  return n == 0 ? nullptr : AllocTraits::allocate(alloc_, n);
 }
 
-template <class T>
-Vector<T>::Vector(size_t n) : data_(nullptr), size_(n), capacity_(n) {
-  if (size_) {
-    try {
-      data_ = new std::byte[capacity_ * sizeof(T)];
-      std::uninitialized_default_construct(begin(), end());
-    } catch (...) {
-      delete[] data_;
-      throw;
-    }
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Deallocate() noexcept {
+  if (data_) {
+    AllocTraits::deallocate(alloc_, data_, capacity_);
   }
 }
 
-template <class T>
-Vector<T>::Vector(size_t n, const T& value) : data_(nullptr), size_(n), capacity_(n) {
-  if (size_) {
-    try {
-      data_ = new std::byte[size_ * sizeof(T)];
-      std::uninitialized_fill(begin(), end(), value);
-    } catch (...) {
-      delete[] data_;
-      throw;
-    }
+// Fills an empty vector with n elements in a buffer of cap elements; construct(first, last) must either
+// construct all of them or throw leaving nothing behind, like the std::uninitialized_* algorithms do.
+template <class T, class Allocator, class GrowthPolicy>
+template <class Construct>
+void Vector<T, Allocator, GrowthPolicy>::ConstructWith(size_t n, size_t cap, Construct construct) {
+  data_ = Allocate(cap);
+  capacity_ = cap;
+  try {
+    construct(data_, data_ + n);
+  } catch (...) {
+    Deallocate();
+    data_ = nullptr;
+    capacity_ = 0;
+    throw;
   }
+  size_ = n;
 }
 
-template <class T>
-Vector<T>::Vector(std::initializer_list<T> il) : data_{nullptr}, size_{il.size()}, capacity_{size_} {
-  if (size_) {
-    try {
-      data_ = new std::byte[capacity_ * sizeof(T)];
-      std::uninitialized_copy(il.begin(), il.end(), begin());
-    } catch (...) {
-      delete[] data_;
-      throw;
-    }
-  }
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::StealFrom(Vector& other) noexcept {
+  data_ = other.data_;
+  size_ = other.size_;
+  capacity_ = other.capacity_;
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.capacity_ = 0;
 }
 
-template <class T>
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector() noexcept(noexcept(Allocator()))
+    : data_(nullptr), size_(0), capacity_(0), alloc_() {
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const Allocator& alloc) noexcept
+    : data_(nullptr), size_(0), capacity_(0), alloc_(alloc) {
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(size_t n, const Allocator& alloc) : Vector(alloc) {
+  ConstructWith(n, n, [](T* first, T* last) { std::uninitialized_default_construct(first, last); });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(size_t n, const T& value, const Allocator& alloc) : Vector(alloc) {
+  ConstructWith(n, n, [&value](T* first, T* last) { std::uninitialized_fill(first, last, value); });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const ParallelConstruction& policy, size_t n, const T& value,
+                                           const Allocator& alloc)
+    : Vector(alloc) {
+  ConstructWith(n, n, [&policy, &value](T* first, T* last) {
+    detail::ParallelConstruct(policy, first, static_cast<size_t>(last - first),
+                              [&value](T* start, T* finish) { std::uninitialized_fill(start, finish, value); });
+  });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(std::initializer_list<T> il, const Allocator& alloc) : Vector(alloc) {
+  ConstructWith(il.size(), il.size(),
+                [&il](T* first, T*) { std::uninitialized_copy(il.begin(), il.end(), first); });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
 template <class ForwardIt, detail::EnifForwardIt<ForwardIt>>
-Vector<T>::Vector(ForwardIt start, ForwardIt finish)
-    : data_{nullptr}, size_{static_cast<size_t>(std::distance(start, finish))}, capacity_{size_} {
-  if (size_) {
-    try {
-      data_ = new std::byte[size_ * sizeof(T)];
-      std::uninitialized_copy(start, finish, begin());
-    } catch (...) {
-      delete[] data_;
-      throw;
-    }
-  }
+Vector<T, Allocator, GrowthPolicy>::Vector(ForwardIt start, ForwardIt finish, const Allocator& alloc) : Vector(alloc) {
+  auto n = static_cast<size_t>(std::distance(start, finish));
+  ConstructWith(n, n, [&start, &finish](T* first, T*) { std::uninitialized_copy(start, finish, first); });
 }
 
-template <class T>
-Vector<T>::Vector(const Vector<T>& other) : data_{nullptr}, size_{other.size_}, capacity_{other.capacity_} {
-  if (size_) {
-    try {
-      data_ = new std::byte[capacity_ * sizeof(T)];
-      std::uninitialized_copy(other.begin(), other.end(), begin());
-    } catch (...) {
-      delete[] data_;
-      throw;
-    }
-  }
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const Vector& other)
+    : Vector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {
 }
 
-template <class T>
-Vector<T>::Vector(Vector<T>&& other) noexcept : data_{nullptr}, size_{other.size_}, capacity_{other.capacity_} {
-  if (size_) {
-    data_ = other.data_;
-    other.data_ = nullptr;
-    other.capacity_ = 0;
-    other.size_ = 0;
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const Vector& other, const Allocator& alloc) : Vector(alloc) {
+  ConstructWith(other.size_, other.capacity_,
+                [&other](T* first, T*) { std::uninitialized_copy(other.begin(), other.end(), first); });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const ParallelConstruction& policy, const Vector& other)
+    : Vector(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+  ConstructWith(other.size_, other.capacity_, [&policy, &other](T* first, T* last) {
+    detail::ParallelConstruct(policy, first, static_cast<size_t>(last - first), [first, &other](T* start, T* finish) {
+      auto src = other.data_ + (start - first);
+      std::uninitialized_copy(src, src + (finish - start), start);
+    });
+  });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(Vector&& other) noexcept : Vector(std::move(other.alloc_)) {
+  StealFrom(other);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(Vector&& other, const Allocator& alloc) : Vector(alloc) {
+  if constexpr (AllocTraits::is_always_equal::value) {
+    StealFrom(other);
+  } else {
+    if (alloc_ == other.alloc_) {
+      StealFrom(other);
+    } else {
+      ConstructWith(other.size_, other.capacity_, [&other](T* first, T*) {
+        std::uninitialized_move(other.begin(), other.end(), first);
+      });
+    }
   }
 }
 
-template <class T>
-Vector<T>& Vector<T>::operator=(const Vector<T>& other) {
+// The copy is built aside with the allocator the result will own, so a throwing copy leaves *this intact.
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>& Vector<T, Allocator, GrowthPolicy>::operator=(const Vector& other) {
   if (this != &other) {
-    auto tmp_size = size_;
-    auto tmp_cap = capacity_;
-    Clear();
-    delete[] data_;
-    size_ = other.size_;
-    capacity_ = other.capacity_;
-    if (size_) {
-      try {
-        data_ = new std::byte[capacity_ * sizeof(T)];
-        std::uninitialized_copy(other.begin(), other.end(), begin());
-      } catch (...) {
-        delete[] data_;
-        data_ = nullptr;
-        capacity_ = tmp_cap;
-        size_ = tmp_size;
-        throw;
-      }
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+      Vector tmp(other, other.alloc_);
+      Clear();
+      Deallocate();
+      alloc_ = tmp.alloc_;
+      StealFrom(tmp);
     } else {
-      data_ = nullptr;
-      capacity_ = 0;
-      size_ = 0;
+      Vector tmp(other, alloc_);
+      Clear();
+      Deallocate();
+      StealFrom(tmp);
     }
   }
   return *this;
 }
 
-template <class T>
-Vector<T>& Vector<T>::operator=(Vector<T>&& other) noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>& Vector<T, Allocator, GrowthPolicy>::operator=(Vector&& other) noexcept(
+    AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
   if (this != &other) {
-    Clear();
-    delete[] data_;
-    data_ = std::move(other.data_);
-    size_ = std::move(other.size_);
-    capacity_ = std::move(other.capacity_);
-    other.size_ = 0;
-    other.capacity_ = 0;
-    other.data_ = nullptr;
+    if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+      Clear();
+      Deallocate();
+      alloc_ = std::move(other.alloc_);
+      StealFrom(other);
+    } else if constexpr (AllocTraits::is_always_equal::value) {
+      Clear();
+      Deallocate();
+      StealFrom(other);
+    } else {
+      Vector tmp(std::move(other), alloc_);
+      Clear();
+      Deallocate();
+      StealFrom(tmp);
+    }
   }
   return *this;
 }
 
-template <class T>
-Vector<T>::~Vector() {
-  if (data_) {
-    Clear();
-  }
-  operator delete[](data_);
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::~Vector() {
+  Clear();
+  Deallocate();
 }
 
-template <class T>
-void Vector<T>::Clear() noexcept {
-  for (size_t i = 0; i < size_; ++i) {
-    std::destroy_at(reinterpret_cast<T*>(data_ + i * sizeof(T)));
-  }
+template <class T, class Allocator, class GrowthPolicy>
+Allocator Vector<T, Allocator, GrowthPolicy>::GetAllocator() const noexcept {
+  return alloc_;
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Clear() noexcept {
+  std::destroy(begin(), end());
   size_ = 0;
 }
 
-template <class T>
-typename Vector<T>::Iterator Vector<T>::begin() noexcept {
-  return reinterpret_cast<T*>(data_);
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator Vector<T, Allocator, GrowthPolicy>::begin() noexcept {
+  return data_;
 }
 
-template <class T>
-typename Vector<T>::Iterator Vector<T>::end() noexcept {
-  return reinterpret_cast<T*>(data_ + size_ * sizeof(T));
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator Vector<T, Allocator, GrowthPolicy>::end() noexcept {
+  return data_ + size_;
 }
 
-template <class T>
-size_t Vector<T>::Size() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::Size() const noexcept {
   return size_;
 }
 
-template <class T>
-size_t Vector<T>::Capacity() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::Capacity() const noexcept {
   return capacity_;
 }
 
-template <class T>
-bool Vector<T>::Empty() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::Empty() const noexcept {
   return (size_ == 0);
 }
 
-template <class T>
-T& Vector<T>::operator[](size_t i) noexcept {
-  return *reinterpret_cast<T*>(data_ + i * sizeof(T));
+template <class T, class Allocator, class GrowthPolicy>
+T& Vector<T, Allocator, GrowthPolicy>::operator[](size_t i) noexcept {
+  return data_[i];
 }
 
-template <class T>
-const T& Vector<T>::operator[](size_t i) const noexcept {
-  return *reinterpret_cast<const T*>(data_ + i * sizeof(T));
+template <class T, class Allocator, class GrowthPolicy>
+const T& Vector<T, Allocator, GrowthPolicy>::operator[](size_t i) const noexcept {
+  return data_[i];
 }
 
-template <class T>
-T& Vector<T>::At(size_t i) {
+template <class T, class Allocator, class GrowthPolicy>
+T& Vector<T, Allocator, GrowthPolicy>::At(size_t i) {
   if (i >= size_) {
     throw std::out_of_range("OutOfRange");
   }
-  return *reinterpret_cast<T*>(data_ + i * sizeof(T));
+  return data_[i];
 }
 
-template <class T>
-const T& Vector<T>::At(size_t i) const {
+template <class T, class Allocator, class GrowthPolicy>
+const T& Vector<T, Allocator, GrowthPolicy>::At(size_t i) const {
   if (i >= size_) {
     throw std::out_of_range("OutOfRange");
   }
-  return *reinterpret_cast<const T*>(data_ + i * sizeof(T));
+  return data_[i];
 }
 
-template <class T>
-T& Vector<T>::Front() noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+T& Vector<T, Allocator, GrowthPolicy>::Front() noexcept {
   return *begin();
 }
 
-template <class T>
-const T& Vector<T>::Front() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+const T& Vector<T, Allocator, GrowthPolicy>::Front() const noexcept {
   return *cbegin();
 }
 
-template <class T>
-T& Vector<T>::Back() noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+T& Vector<T, Allocator, GrowthPolicy>::Back() noexcept {
   return *(end() - 1);
 }
 
-template <class T>
-const T& Vector<T>::Back() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+const T& Vector<T, Allocator, GrowthPolicy>::Back() const noexcept {
   return *(cend() - 1);
 }
 
-template <class T>
-T* Vector<T>::Data() noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+T* Vector<T, Allocator, GrowthPolicy>::Data() noexcept {
   return begin();
 }
 
-template <class T>
-const T* Vector<T>::Data() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+const T* Vector<T, Allocator, GrowthPolicy>::Data() const noexcept {
   return cbegin();
 }
 
-template <class T>
-void Vector<T>::Swap(Vector<T>& other) noexcept {
+// Allocators that do not propagate on swap must compare equal, as for std::vector.
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Swap(Vector& other) noexcept {
+  if constexpr (AllocTraits::propagate_on_container_swap::value) {
+    std::swap(alloc_, other.alloc_);
+  }
   std::swap(size_, other.size_);
   std::swap(capacity_, other.capacity_);
   std::swap(data_, other.data_);
 }
 
-template <class T>
-void Vector<T>::Reserve(size_t new_cap) {
-  if (new_cap > capacity_) {
-    auto tmp_cap = capacity_;
-    auto tmp = data_;
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::GrowTo(size_t required) const noexcept {
+  return GrowthPolicy::Grow(size_, required, sizeof(T));
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::NoteReallocation([[maybe_unused]] size_t new_cap) const noexcept {
+#ifdef VECTOR_COLLECT_STATS
+  VectorStats<T>::Record(size_, new_cap);
+#endif
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Reallocate(size_t new_cap) {
+  NoteReallocation(new_cap);
+  if constexpr (kReallocatesInPlace) {
+    data_ = alloc_.reallocate(data_, capacity_, new_cap, size_);
     capacity_ = new_cap;
-    try {
-      data_ = new std::byte[capacity_ * sizeof(T)];
-    } catch (...) {
-      delete[] data_;
-      data_ = tmp;
-      capacity_ = tmp_cap;
-      throw;
-    }
-    if (size_) {
-      std::uninitialized_move(reinterpret_cast<T*>(tmp), reinterpret_cast<T*>(tmp + size_ * sizeof(T)), begin());
-    }
-    for (size_t i = 0; i < size_; ++i) {
-      std::destroy_at(reinterpret_cast<T*>(tmp + i * sizeof(T)));
-    }
-    delete[] tmp;
+    return;
   }
+  auto new_data = Allocate(new_cap);
+  detail::UninitializedRelocate(begin(), end(), new_data);
+  Deallocate();
+  data_ = new_data;
+  capacity_ = new_cap;
 }
 
-template <class T>
-void Vector<T>::Resize(size_t n) {
-  if (n > size_) {
-    if (n > capacity_) {
-      auto tmp_cap = capacity_;
-      auto tmp = data_;
-      auto tmp_size = size_;
-      capacity_ = n;
-      try {
-        data_ = new std::byte[capacity_ * sizeof(T)];
-        std::uninitialized_move(reinterpret_cast<T*>(tmp), reinterpret_cast<T*>(tmp + size_ * sizeof(T)), begin());
-        std::uninitialized_default_construct(reinterpret_cast<T*>(data_ + size_ * sizeof(T)),
-                                             reinterpret_cast<T*>(data_ + n * sizeof(T)));
-      } catch (...) {
-        Clear();
-        delete[] data_;
-        data_ = tmp;
-        capacity_ = tmp_cap;
-        size_ = tmp_size;
-        throw;
-      }
-      for (size_t i = 0; i < size_; ++i) {
-        std::destroy_at(reinterpret_cast<T*>(tmp + i * sizeof(T)));
-      }
-      delete[] tmp;
-    } else {
-      try {
-        std::uninitialized_default_construct(reinterpret_cast<T*>(data_ + size_ * sizeof(T)),
-                                             reinterpret_cast<T*>(data_ + n * sizeof(T)));
-      } catch (...) {
-        throw;
-      }
-    }
+template <class T, class Allocator, class GrowthPolicy>
+template <class Construct>
+void Vector<T, Allocator, GrowthPolicy>::ReallocateAndConstruct(size_t new_cap, size_t new_size, Construct construct) {
+  if constexpr (kReallocatesInPlace) {
+    // The old buffer is gone after this, so callers copy arguments that may refer into it beforehand. A
+    // throwing constructor leaves the elements as they were, only in a larger buffer.
+    Reallocate(new_cap);
+    construct(data_ + size_, data_ + new_size);
+    size_ = new_size;
+    return;
+  }
+  NoteReallocation(new_cap);
+  auto new_data = detail::RelocatingGrow(alloc_, data_, size_, new_cap, size_, new_size - size_, construct);
+  Deallocate();
+  data_ = new_data;
+  capacity_ = new_cap;
+  size_ = new_size;
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Reserve(size_t new_cap) {
+  if (new_cap > capacity_) {
+    Reallocate(new_cap);
+  }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Resize(size_t n) {
+  if (n <= size_) {
+    std::destroy(begin() + n, end());
     size_ = n;
-  } else {
-    if (size_ == n) {
-      return;
-    }
-    if (data_) {
-      for (size_t i = n; i < size_; ++i) {
-        std::destroy_at(reinterpret_cast<T*>(data_ + i * sizeof(T)));
-      }
-    }
+  } else if (n <= capacity_) {
+    std::uninitialized_default_construct(end(), begin() + n);
     size_ = n;
+  } else {
+    ReallocateAndConstruct(GrowthPolicy::kAmortizedResize ? GrowTo(n) : n, n,
+                           [](T* first, T* last) { std::uninitialized_default_construct(first, last); });
   }
 }
 
-template <class T>
-void Vector<T>::Resize(size_t n, const T& value) {
-  if (n > size_) {
-    if (n > capacity_) {
-      auto tmp_cap = capacity_;
-      auto tmp = data_;
-      auto tmp_size = size_;
-      capacity_ = n;
-      try {
-        data_ = new std::byte[capacity_ * sizeof(T)];
-        std::uninitialized_move(reinterpret_cast<T*>(tmp), reinterpret_cast<T*>(tmp + size_ * sizeof(T)), begin());
-        std::uninitialized_fill(reinterpret_cast<T*>(data_ + size_ * sizeof(T)),
-                                reinterpret_cast<T*>(data_ + n * sizeof(T)), value);
-      } catch (...) {
-        Clear();
-        delete[] data_;
-        data_ = tmp;
-        capacity_ = tmp_cap;
-        size_ = tmp_size;
-        throw;
-      }
-      for (size_t i = 0; i < size_; ++i) {
-        std::destroy_at(reinterpret_cast<T*>(tmp + i * sizeof(T)));
-      }
-      delete[] tmp;
-    } else {
-      try {
-        std::uninitialized_fill(reinterpret_cast<T*>(data_ + size_ * sizeof(T)),
-                                reinterpret_cast<T*>(data_ + n * sizeof(T)), value);
-      } catch (...) {
-        throw;
-      }
-    }
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Resize(size_t n, const T& value) {
+  ResizeWith(n, value, [](T* first, T* last, const T& fill) { std::uninitialized_fill(first, last, fill); });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Resize(const ParallelConstruction& policy, size_t n, const T& value) {
+  ResizeWith(n, value, [&policy](T* first, T* last, const T& fill) {
+    detail::ParallelConstruct(policy, first, static_cast<size_t>(last - first),
+                              [&fill](T* start, T* finish) { std::uninitialized_fill(start, finish, fill); });
+  });
+}
+
+// Resize(n, value) with fill(first, last, value) constructing the new elements.
+template <class T, class Allocator, class GrowthPolicy>
+template <class Fill>
+void Vector<T, Allocator, GrowthPolicy>::ResizeWith(size_t n, const T& value, Fill fill) {
+  if (n <= size_) {
+    std::destroy(begin() + n, end());
+    size_ = n;
+  } else if (n <= capacity_) {
+    fill(end(), begin() + n, value);
     size_ = n;
   } else {
-    if (size_ == n) {
-      return;
-    }
-    if (data_) {
-      for (size_t i = n; i < size_; ++i) {
-        std::destroy_at(reinterpret_cast<T*>(data_ + i * sizeof(T)));
+    if constexpr (kReallocatesInPlace) {
+      if (Owns(&value)) {
+        T copy(value);
+        ResizeWith(n, copy, fill);
+        return;
       }
     }
+    ReallocateAndConstruct(GrowthPolicy::kAmortizedResize ? GrowTo(n) : n, n,
+                           [&value, &fill](T* first, T* last) { fill(first, last, value); });
+  }
+}
+
+// For buffers that are about to be overwritten, e.g. by read(): new elements are default-initialized, which
+// leaves trivial types untouched, and growth is amortized by the policy, so filling a buffer chunk by chunk
+// is linear.
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::ResizeForOverwrite(size_t n) {
+  if (n <= size_) {
+    std::destroy(begin() + n, end());
+    size_ = n;
+  } else if (n <= capacity_) {
+    std::uninitialized_default_construct(end(), begin() + n);
     size_ = n;
+  } else {
+    ReallocateAndConstruct(GrowTo(n), n, [](T* first, T* last) { std::uninitialized_default_construct(first, last); });
   }
 }
 
-template <class T>
-void Vector<T>::ShrinkToFit() {
+// Grows the vector by n default-initialized elements and returns them; the span is invalidated by the next
+// reallocation.
+template <class T, class Allocator, class GrowthPolicy>
+std::span<T> Vector<T, Allocator, GrowthPolicy>::AppendUninitialized(size_t n) {
+  auto old_size = size_;
+  ResizeForOverwrite(size_ + n);
+  return {data_ + old_size, n};
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::ShrinkToFit() {
   if (size_ == 0) {
-    Clear();
-    delete[] data_;
+    Deallocate();
     data_ = nullptr;
     capacity_ = 0;
     return;
   }
-  auto tmp_cap = capacity_;
-  auto tmp = data_;
-  capacity_ = size_;
+  if (size_ < capacity_) {
+    Reallocate(size_);
+  }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::PushBack(const T& value) {
+  EmplaceBack(value);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+template <class... Args>
+void Vector<T, Allocator, GrowthPolicy>::EmplaceBack(Args&&... args) {
+  if (size_ < capacity_) {
+    new (end()) T(std::forward<Args>(args)...);
+    ++size_;
+    return;
+  }
+  if constexpr (kReallocatesInPlace) {
+    T value(std::forward<Args>(args)...);
+    Reallocate(GrowTo(size_ + 1));
+    new (end()) T(std::move(value));
+    ++size_;
+  } else {
+    ReallocateAndConstruct(GrowTo(size_ + 1), size_ + 1,
+                           [&args...](T* first, T*) { new (first) T(std::forward<Args>(args)...); });
+  }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::PushBack(T&& value) {
+  EmplaceBack(std::move(value));
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::PopBack() noexcept {
+  size_--;
+  std::destroy_at(data_ + size_);
+}
+
+// Opens a gap of count elements at pos, reallocating at most once, and fills it with construct. If that
+// throws, the tail is relocated back (or the new buffer is dropped), so the vector is left unchanged.
+template <class T, class Allocator, class GrowthPolicy>
+template <class Construct>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator
+Vector<T, Allocator, GrowthPolicy>::InsertWith(size_t pos, size_t count, Construct construct) {
+  if (count == 0) {
+    return data_ + pos;
+  }
+  if (size_ + count > capacity_) {
+    auto new_cap = GrowTo(size_ + count);
+    if constexpr (!kReallocatesInPlace) {
+      NoteReallocation(new_cap);
+      auto new_data = detail::RelocatingGrow(alloc_, data_, size_, new_cap, pos, count, construct);
+      Deallocate();
+      data_ = new_data;
+      capacity_ = new_cap;
+      size_ += count;
+      return data_ + pos;
+    }
+    Reallocate(new_cap);
+  }
+  auto gap = data_ + pos;
+  detail::UninitializedRelocateWithin(gap, end(), gap + count);
   try {
-    data_ = new std::byte[capacity_ * sizeof(T)];
+    construct(gap, gap + count);
   } catch (...) {
-    delete[] data_;
-    data_ = tmp;
-    capacity_ = tmp_cap;
+    detail::UninitializedRelocateWithin(gap + count, end() + count, gap);
     throw;
   }
-  std::uninitialized_move(reinterpret_cast<T*>(tmp), reinterpret_cast<T*>(tmp + size_ * sizeof(T)), begin());
-  for (size_t i = 0; i < size_; ++i) {
-    std::destroy_at(reinterpret_cast<T*>(tmp + i * sizeof(T)));
-  }
-  delete[] tmp;
+  size_ += count;
+  return gap;
 }
 
-template <class T>
-void Vector<T>::PushBack(const T& value) {
-  if (size_ >= capacity_) {
-    auto tmp_cap = capacity_;
-    auto tmp = data_;
-    auto tmp_size = size_;
-    capacity_ = size_ == 0 ? 2 : size_ * 2;
-    try {
-      data_ = new std::byte[capacity_ * sizeof(T)];
-      std::uninitialized_move(reinterpret_cast<T*>(tmp), reinterpret_cast<T*>(tmp + size_ * sizeof(T)), begin());
-      std::uninitialized_fill(end(), end() + 1, value);
-    } catch (...) {
-      Clear();
-      delete[] data_;
-      data_ = tmp;
-      capacity_ = tmp_cap;
-      size_ = tmp_size;
-      throw;
-    }
-    for (size_t i = 0; i < size_; ++i) {
-      std::destroy_at(reinterpret_cast<T*>(tmp + i * sizeof(T)));
-    }
-    size_++;
-    delete[] tmp;
-  } else {
-    try {
-      std::uninitialized_fill(end(), end() + 1, value);
-    } catch (...) {
-      throw;
-    }
-    size_++;
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::Owns(const T* ptr) const noexcept {
+  return std::less_equal<const T*>()(cbegin(), ptr) && std::less<const T*>()(ptr, cend());
+}
+
+// A value that lives in the vector itself would be shifted away before it is copied, so it is copied first.
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator
+Vector<T, Allocator, GrowthPolicy>::Insert(ConstIterator pos, const T& value) {
+  if (Owns(&value)) {
+    T copy(value);
+    return Insert(pos, std::move(copy));
   }
+  return InsertWith(pos - cbegin(), 1, [&value](T* first, T*) { new (first) T(value); });
 }
 
-template <class T>
-template <class... Args>
-void Vector<T>::EmplaceBack(Args&&... args) {
-  if (size_ >= capacity_) {
-    auto tmp_cap = capacity_;
-    auto tmp = data_;
-    capacity_ = size_ == 0 ? 2 : size_ * 2;
-    try {
-      data_ = new std::byte[capacity_ * sizeof(T)];
-      std::uninitialized_move(reinterpret_cast<T*>(tmp), reinterpret_cast<T*>(tmp + size_ * sizeof(T)), begin());
-      new (data_ + sizeof(T) * size_) T(std::forward<Args>(args)...);
-    } catch (...) {
-      delete[] data_;
-      data_ = tmp;
-      capacity_ = tmp_cap;
-      throw;
-    }
-    for (size_t i = 0; i < size_; ++i) {
-      std::destroy_at(reinterpret_cast<T*>(tmp + i * sizeof(T)));
-    }
-    size_++;
-    delete[] tmp;
-  } else {
-    try {
-      new (data_ + sizeof(T) * size_) T(std::forward<Args>(args)...);
-      size_++;
-    } catch (...) {
-      throw;
-    }
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator
+Vector<T, Allocator, GrowthPolicy>::Insert(ConstIterator pos, T&& value) {
+  if (Owns(&value)) {
+    T copy(std::move(value));
+    return Insert(pos, std::move(copy));
   }
+  return InsertWith(pos - cbegin(), 1, [&value](T* first, T*) { new (first) T(std::move(value)); });
 }
 
-template <class T>
-void Vector<T>::PushBack(T&& value) {
-  if (size_ >= capacity_) {
-    auto tmp_cap = capacity_;
-    auto tmp = data_;
-    capacity_ = size_ == 0 ? 2 : size_ * 2;
-    try {
-      data_ = new std::byte[capacity_ * sizeof(T)];
-      std::uninitialized_move(reinterpret_cast<T*>(tmp), reinterpret_cast<T*>(tmp + size_ * sizeof(T)), begin());
-      new (end()) T(std::move(value));
-    } catch (...) {
-      delete[] data_;
-      data_ = tmp;
-      capacity_ = tmp_cap;
-      throw;
-    }
-    for (size_t i = 0; i < size_; ++i) {
-      std::destroy_at(reinterpret_cast<T*>(tmp + i * sizeof(T)));
-    }
-    size_++;
-    delete[] tmp;
-  } else {
-    try {
-      new (end()) T(std::move(value));
-      size_++;
-    } catch (...) {
-      throw;
-    }
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator
+Vector<T, Allocator, GrowthPolicy>::Insert(ConstIterator pos, size_t n, const T& value) {
+  if (Owns(&value)) {
+    T copy(value);
+    return Insert(pos, n, copy);
   }
+  return InsertWith(pos - cbegin(), n,
+                    [&value](T* first, T* last) { std::uninitialized_fill(first, last, value); });
 }
 
-template <class T>
-void Vector<T>::PopBack() noexcept {
-  size_--;
-  std::destroy_at(reinterpret_cast<const T*>(data_ + sizeof(T) * size_));
+// As for std::vector, [start, finish) must not point into the vector itself.
+template <class T, class Allocator, class GrowthPolicy>
+template <class ForwardIt, detail::EnifForwardIt<ForwardIt>>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator
+Vector<T, Allocator, GrowthPolicy>::Insert(ConstIterator pos, ForwardIt start, ForwardIt finish) {
+  return InsertWith(pos - cbegin(), static_cast<size_t>(std::distance(start, finish)),
+                    [&start, &finish](T* first, T*) { std::uninitialized_copy(start, finish, first); });
 }
 
-template <class T>
-bool operator==(const Vector<T>& vec1, const Vector<T>& vec2) {
-  if (vec1.Size() == vec2.Size()) {
-    for (size_t i = 0; i < vec1.Size(); ++i) {
-      if (vec1[i] != vec2[i]) {
-        return false;
-      }
-    }
-    return true;
+template <class T, class Allocator, class GrowthPolicy>
+template <class ForwardIt, detail::EnifForwardIt<ForwardIt>>
+void Vector<T, Allocator, GrowthPolicy>::Append(ForwardIt start, ForwardIt finish) {
+  Insert(cend(), start, finish);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator
+Vector<T, Allocator, GrowthPolicy>::Erase(ConstIterator pos) noexcept {
+  return Erase(pos, pos + 1);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::Iterator
+Vector<T, Allocator, GrowthPolicy>::Erase(ConstIterator start, ConstIterator finish) noexcept {
+  auto first = data_ + (start - cbegin());
+  auto last = data_ + (finish - cbegin());
+  if (first != last) {
+    std::destroy(first, last);
+    detail::UninitializedRelocateWithin(last, end(), first);
+    size_ -= static_cast<size_t>(last - first);
   }
-  return false;
+  return first;
 }
 
-template <class T>
-bool operator!=(const Vector<T>& vec1, const Vector<T>& vec2) {
+template <class T, class Allocator, class GrowthPolicy>
+bool operator==(const Vector<T, Allocator, GrowthPolicy>& vec1, const Vector<T, Allocator, GrowthPolicy>& vec2) {
+  return detail::RangesEqual(vec1.Data(), vec1.Size(), vec2.Data(), vec2.Size());
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+bool operator!=(const Vector<T, Allocator, GrowthPolicy>& vec1, const Vector<T, Allocator, GrowthPolicy>& vec2) {
   return !(vec1 == vec2);
 }
 
-template <class T>
-bool operator<=(const Vector<T>& vec1, const Vector<T>& vec2) {
+template <class T, class Allocator, class GrowthPolicy>
+bool operator<=(const Vector<T, Allocator, GrowthPolicy>& vec1, const Vector<T, Allocator, GrowthPolicy>& vec2) {
   return (vec2 >= vec1);
 }
 
-template <class T>
-bool operator>=(const Vector<T>& vec1, const Vector<T>& vec2) {
+template <class T, class Allocator, class GrowthPolicy>
+bool operator>=(const Vector<T, Allocator, GrowthPolicy>& vec1, const Vector<T, Allocator, GrowthPolicy>& vec2) {
   return !(vec1 < vec2);
 }
 
-template <class T>
-bool operator<(const Vector<T>& first, const Vector<T>& second) {
-  auto size1 = first.Size();
-  auto size2 = second.Size();
-  size_t i = 0;
-  while (i < size1 && i < size2) {
-    if (first[i] < second[i]) {
-      return true;
-    }
-    if (first[i] > second[i]) {
-      return false;
-    }
-    ++i;
-  }
-  return (size1 < size2);
+template <class T, class Allocator, class GrowthPolicy>
+bool operator<(const Vector<T, Allocator, GrowthPolicy>& first, const Vector<T, Allocator, GrowthPolicy>& second) {
+  return detail::RangesLess(first.Data(), first.Size(), second.Data(), second.Size());
 }
 
-template <class T>
-bool operator>(const Vector<T>& vec1, const Vector<T>& vec2) {
+template <class T, class Allocator, class GrowthPolicy>
+bool operator>(const Vector<T, Allocator, GrowthPolicy>& vec1, const Vector<T, Allocator, GrowthPolicy>& vec2) {
   return (vec2 < vec1);
 }
 
-template <class T>
-typename Vector<T>::ConstIterator Vector<T>::begin() const noexcept {
-  return reinterpret_cast<const T*>(data_);
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstIterator Vector<T, Allocator, GrowthPolicy>::begin() const noexcept {
+  return data_;
 }
 
-template <class T>
-typename Vector<T>::ConstIterator Vector<T>::cbegin() const noexcept {
-  return reinterpret_cast<const T*>(data_);
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstIterator Vector<T, Allocator, GrowthPolicy>::cbegin() const noexcept {
+  return data_;
 }
 
-template <class T>
-typename Vector<T>::ConstIterator Vector<T>::end() const noexcept {
-  return reinterpret_cast<const T*>(data_ + sizeof(T) * size_);
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstIterator Vector<T, Allocator, GrowthPolicy>::end() const noexcept {
+  return data_ + size_;
 }
 
-template <class T>
-typename Vector<T>::ConstIterator Vector<T>::cend() const noexcept {
-  return reinterpret_cast<const T*>(data_ + sizeof(T) * size_);
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstIterator Vector<T, Allocator, GrowthPolicy>::cend() const noexcept {
+  return data_ + size_;
 }
 
-template <class T>
-typename Vector<T>::ReverseIterator Vector<T>::rbegin() noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ReverseIterator Vector<T, Allocator, GrowthPolicy>::rbegin() noexcept {
   return ReverseIterator(end());
 }
 
-template <class T>
-typename Vector<T>::ConstReverseIterator Vector<T>::rbegin() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstReverseIterator
+Vector<T, Allocator, GrowthPolicy>::rbegin() const noexcept {
   return ConstReverseIterator(cend());
 }
 
-template <class T>
-typename Vector<T>::ConstReverseIterator Vector<T>::crbegin() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstReverseIterator
+Vector<T, Allocator, GrowthPolicy>::crbegin() const noexcept {
   return ConstReverseIterator(cend());
 }
 
-template <class T>
-typename Vector<T>::ReverseIterator Vector<T>::rend() noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ReverseIterator Vector<T, Allocator, GrowthPolicy>::rend() noexcept {
   return ReverseIterator(begin());
 }
 
-template <class T>
-typename Vector<T>::ConstReverseIterator Vector<T>::rend() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstReverseIterator
+Vector<T, Allocator, GrowthPolicy>::rend() const noexcept {
   return ConstReverseIterator(cbegin());
 }
 
-template <class T>
-typename Vector<T>::ConstReverseIterator Vector<T>::crend() const noexcept {
+template <class T, class Allocator, class GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::ConstReverseIterator
+Vector<T, Allocator, GrowthPolicy>::crend() const noexcept {
   return ConstReverseIterator(cbegin());
 }